@@ -0,0 +1,1356 @@
+// - - - - -
+// GFXDraw - A Arduino library for drawing shapes on a GFX display using paths describing the borders.
+// main.cpp: Benchmark program measuring the library functions on a Linux or Windows host.
+//
+// Copyright (c) 2024-2024 by Matthias Hertel, http://www.mathertel.de
+// This work is licensed under a BSD style license. See http://www.mathertel.de/License.aspx
+//
+// The results are printed as one JSON object per line to stdout.
+//
+// The benchmark_nofloat program is the same program using the library built with GFXDRAW_NO_FLOAT.
+//
+// Usage: benchmark [--quick] [--filter <text>] [--check]
+//   --quick   run every benchmark only for a short time (used by ctest).
+//   --filter  run only benchmarks with a name containing the text.
+//   --check   only check that all fillSegments variants pass the same pixels once to the callbacks (used by ctest).
+//
+// - - - - -
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <new>
+#include <thread>
+
+#include "gfxDraw.h"
+#include "gfxDrawPathWidget.h"
+#include "gfxDrawGaugeWidget.h"
+#include "gfxDrawSprite.h"
+
+using namespace gfxDraw;
+
+
+// ===== Allocation counting =====
+
+static std::atomic<uint64_t> _allocations(0);
+
+void *operator new(size_t size) {
+  _allocations.fetch_add(1, std::memory_order_relaxed);
+  void *p = malloc(size ? size : 1);
+  if (!p) throw std::bad_alloc();
+  return (p);
+}
+
+void operator delete(void *p) noexcept {
+  free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+  free(p);
+}
+
+
+// ===== Framebuffer =====
+
+#define FRAME_WIDTH 2048
+#define FRAME_HEIGHT 2048
+
+static ARGB *_frame;
+
+/// @brief when true the drawn pixels are counted.
+static bool _counting = false;
+
+/// @brief number of pixels drawn while counting.
+static std::atomic<uint64_t> _pixels(0);
+
+/// @brief memory size of the measured data, printed by the next measurement when not 0.
+static size_t _memoryBytes = 0;
+
+static inline void framePixel(int16_t x, int16_t y, ARGB color) {
+  if ((x >= 0) && (x < FRAME_WIDTH) && (y >= 0) && (y < FRAME_HEIGHT)) {
+    _frame[y * FRAME_WIDTH + x] = color;
+  }
+  if (_counting) _pixels.fetch_add(1, std::memory_order_relaxed);
+}
+
+static inline void frameSpan(int16_t x0, int16_t x1, int16_t y, ARGB color) {
+  if ((y >= 0) && (y < FRAME_HEIGHT)) {
+    int16_t xs = (x0 < 0 ? 0 : x0);
+    int16_t xe = (x1 >= FRAME_WIDTH ? FRAME_WIDTH - 1 : x1);
+    ARGB *p = _frame + y * FRAME_WIDTH;
+    for (int16_t x = xs; x <= xe; x++) { p[x] = color; }
+  }
+  if (_counting) _pixels.fetch_add(x1 - x0 + 1, std::memory_order_relaxed);
+}
+
+static inline void frameRow(int16_t x, int16_t y, const ARGB *pixels, int16_t len) {
+  if ((y >= 0) && (y < FRAME_HEIGHT)) {
+    int16_t xs = (x < 0 ? 0 : x);
+    int16_t xe = (x + len > FRAME_WIDTH ? FRAME_WIDTH : x + len);
+    if (xs < xe) memcpy(_frame + y * FRAME_WIDTH + xs, pixels + (xs - x), (xe - xs) * sizeof(ARGB));
+  }
+  if (_counting) _pixels.fetch_add(len, std::memory_order_relaxed);
+}
+
+static void cbBorder(int16_t x, int16_t y) {
+  framePixel(x, y, ARGB_BLACK);
+}
+
+static void cbFill(int16_t x0, int16_t x1, int16_t y) {
+  frameSpan(x0, x1, y, ARGB_SILVER);
+}
+
+static void cbText(int16_t x, int16_t y) {
+  framePixel(x, y, ARGB_BLUE);
+}
+
+
+// ===== Test corpus =====
+
+// These paths are also used in the png example.
+
+const char *SmilieCurvePath =
+  "M24 0c-14 0-24 10-24 24 c0 14 10 24 24 24 c14 0 24-10 24-24 c0-14-10-24-24-24Z"
+  "M16 12c5 0 5 7 0 7 c-5 0-5-7 0-7Z"
+  "M32 12c5 0 5 7 0 7 c-5 0-5-7 0-7Z"
+  "M38 32c0 1-1 2-2 3 c-6 5-12 6-19 3 c-2-2-5-3-5-6 c1-2 3 0 4 1 c4 3 9 5 15 2 c3-2 3-2 5-4 c1-1 2-1 2 1Z";
+
+const char *SmileyArcPath =
+  "M44 24 a20 20 0 0 1 -20 20A20 20 0 0 1 4 24 A20 20 0 0 1 24 4 a20 20 0 0 1 20 20z"
+  "M20 16 a 4 4 0 0 1  -4 4 a4 4 0 0 1 -4 -4 a4 4 0 0 1 4-4 a4 4 0 0 1 4 4z"
+  "M36 16 a 4 4 0 0 1  -4 4 a4 4 0 0 1 -4 -4 a4 4 0 0 1 4-4 a4 4 0 0 1 4 4z"
+  "M36 32 a 12 4 0 0 1 -12 4 a12 4 0 0 1-12-4 a12 4 0 0 1 12-4 a12 4 0 0 1 12 4z";
+
+constexpr const char *swordPath =
+  "M 40 80 L 100 10 L 130 0 L 120 30 L 50 90 C 60 100 60 110 70 100 C 70 110 80 120 70 120 A 14 14 0 0 1 60 130 "
+  "A 50 50 0 0 0 40 100 C 36 99 36 99 35 105 l -15 13 C 10 121 10 121 12 110 L 25 95 C 31 94 31 94 30 90 "
+  "A 50 50 90 0 0 0 70 A 14 14 0 0 1 10 60 C 10 50 20 60 30 60 C 20 70 30 70 40 80 "
+  "M 100 10 L 100 30 L 120 30 L 102 28 L 100 10z";
+
+constexpr const char *keyPath =
+  "M177 10l-87 128 1 1 16 11 88-128L177 10z"
+  "m45 31c-10 15-22 12-34 4l-24 36c11 8 18 18 9 31l21 15 14-21-7-5c-2 1-3 1-5 1-6 0-11-5-11-11 0-6 5-11 11-11s11 5 11 11c0 0 0 0 0 0l8 5 9-13-19-12 6-9 7 5 5-8 12 8 9-12-21-15z"
+  "M70 136c0 0 0 0 0 0 0 0-1 0-1 0-2 1-4 2-5 4-1 2-2 4-2 6 0 2 1 3 3 5l38 27c2 1 3 1 5 1 2-1 4-2 5-4 1-2 2-4 2-6 0-2 0-3-2-4L73 137c-1-1-2-1-3-1z"
+  "M41 158c-12 0-23 5-29 14-8 12-6 30 5 45-1 2-1 5-1 8 0 12 10 21 21 21 4 0 8-1 12-4 22 9 44 6 54-8 9-14 5-33-8-50l-32-22c-7-3-14-4-21-4 0 0-1 0-1 0z"
+  "m-4 55c7 0 12 5 12 12 0 7-5 12-12 12-7 0-12-5-12-12s5-12 12-12z";
+
+// clock hands and marks as used in the moonclock example.
+const char *mark05Path = "M0 -252 l8 -8 l-8 -8 l-8 8 z";
+const char *hhPath = "M-8 16 v-132 a 1 1 0 0 1 16 0 v132z";
+const char *mmPath = "M-4 32 v-180 a 15,15 0 0 1 0 -30 v-20 h8 v20 a 15,15 0 0 1 0 30  v180z";
+const char *ssPath = "M0 48 v-286";
+
+struct CorpusPath {
+  const char *name;
+  const char *path;
+};
+
+const CorpusPath corpus[] = {
+  { "swordPath", swordPath },
+  { "keyPath", keyPath },
+  { "SmilieCurvePath", SmilieCurvePath },
+  { "SmileyArcPath", SmileyArcPath },
+};
+
+/// scaling factors in percent used for the paths.
+const int16_t scales[] = { 100, 400, 1000 };
+
+const char *benchText = "ABCDEFGHIJKLMNOPQRSTUVWXYZ abcdefghijklmnopqrstuvwxyz 1234567890";
+
+
+// ===== Measuring =====
+
+/// @brief minimal time for measuring a benchmark in nanoseconds.
+static int64_t _minTime = 200000000;
+
+/// @brief only benchmarks with a name containing this text are run.
+static const char *_filter = nullptr;
+
+static int64_t _nanoseconds() {
+  return (std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/// @brief Measure a single benchmark and print the result as a JSON line.
+/// @param bench Name of the function that is measured.
+/// @param item Name of the corpus item.
+/// @param scale scaling factor in percent or 0 when not applicable.
+/// @param variant Name of the options used.
+/// @param op the operation to be measured.
+template<typename TOp>
+void measure(const char *bench, const char *item, int16_t scale, const char *variant, TOp &&op) {
+  char name[128];
+  snprintf(name, sizeof(name), "%s/%s/%d/%s", bench, item, scale, variant);
+  if (_filter && !strstr(name, _filter)) {
+    _memoryBytes = 0;
+    return;
+  }
+
+  // first run for counting pixels and allocations.
+  _pixels = 0;
+  _counting = true;
+  uint64_t allocStart = _allocations;
+  op();
+  uint64_t allocs = _allocations - allocStart;
+  uint64_t pixels = _pixels;
+  _counting = false;
+
+#ifdef GFXDRAW_STATS
+  DrawStats stats = lastDrawStats();
+#endif
+
+  // timed runs
+  int64_t iterations = 0;
+  int64_t start = _nanoseconds();
+  int64_t elapsed = 0;
+  int64_t batch = 1;
+
+  while (elapsed < _minTime) {
+    for (int64_t n = 0; n < batch; n++) { op(); }
+    iterations += batch;
+    elapsed = _nanoseconds() - start;
+    if (batch < 1024) batch *= 2;
+  }
+
+  double nsPerOp = (double)elapsed / iterations;
+  double pixelsPerSecond = (nsPerOp > 0 ? pixels * 1e9 / nsPerOp : 0);
+
+#ifdef GFXDRAW_NO_FLOAT
+  const char *mode = "nofloat";
+#else
+  const char *mode = "float";
+#endif
+
+  printf("{\"bench\":\"%s\",\"item\":\"%s\",\"scale\":%d,\"variant\":\"%s\",\"mode\":\"%s\",\"iterations\":%lld,"
+         "\"ns_per_op\":%.1f,\"pixels_per_op\":%llu,\"pixels_per_s\":%.0f,\"allocs_per_op\":%llu",
+         bench, item, scale, variant, mode, (long long)iterations,
+         nsPerOp, (unsigned long long)pixels, pixelsPerSecond, (unsigned long long)allocs);
+
+  if (_memoryBytes) {
+    printf(",\"memory_bytes\":%llu", (unsigned long long)_memoryBytes);
+    _memoryBytes = 0;
+  }
+
+#ifdef GFXDRAW_STATS
+  // statistics of the last drawing call in the first run.
+  printf(",\"stats\":{\"segments\":%u,\"borderPixels\":%u,\"fillPixels\":%u,\"edges\":%u,\"markerEdges\":%u,"
+         "\"sortSize\":%u,\"gapFills\":%u,\"lineFallbacks\":%u,\"spriteResizes\":%u}",
+         stats.segments, stats.borderPixels, stats.fillPixels, stats.edges, stats.markerEdges,
+         stats.sortSize, stats.gapFills, stats.lineFallbacks, stats.spriteResizes);
+#endif
+
+  printf("}\n");
+  fflush(stdout);
+}  // measure()
+
+
+/// @brief parse and scale a path from the corpus.
+std::vector<Segment> scaledPath(const char *path, int16_t scale) {
+  std::vector<Segment> segs = parsePath(path);
+  scaleSegments(segs, scale);
+  return (segs);
+}
+
+
+// ===== Benchmarks =====
+
+void benchParsePath() {
+  for (const CorpusPath &c : corpus) {
+    measure("parsePath", c.name, 0, "-", [&]() {
+      std::vector<Segment> segs = parsePath(c.path);
+    });
+  }
+
+  // parsed at compile time, only copying the segments to the stack remains at runtime.
+  static constexpr auto swordSegments = GFXDRAW_PATH(swordPath);
+  measure("parsePath", "swordPath", 0, "constexpr", [&]() {
+    std::array<Segment, swordSegments.size()> segs = swordSegments;
+    moveSegments(segs.data(), segs.size(), 0, 0);
+  });
+}
+
+
+void benchDrawSegments() {
+  for (const CorpusPath &c : corpus) {
+    for (int16_t scale : scales) {
+      std::vector<Segment> segs = scaledPath(c.path, scale);
+      measure("drawSegments", c.name, scale, "-", [&]() {
+        drawSegments(segs, cbBorder);
+      });
+      measure("drawSegments", c.name, scale, "width5", [&]() {
+        drawSegments(segs, 5, cbFill, StrokeFlags::RoundJoin);
+      });
+    }
+  }
+}
+
+
+void benchFillSegments() {
+  struct Variant {
+    const char *name;
+    FillFlags flags;
+  };
+
+  const Variant variants[] = {
+    { "EdgeTrace", FillFlags::EdgeTrace },
+    { "EdgeTrace|NonZero", FillFlags::EdgeTrace | FillFlags::NonZero },
+    { "EdgeTrace|Parallel", FillFlags::EdgeTrace | FillFlags::Parallel },
+  };
+
+  for (const CorpusPath &c : corpus) {
+    for (int16_t scale : scales) {
+      std::vector<Segment> segs = scaledPath(c.path, scale);
+      for (const Variant &v : variants) {
+        measure("fillSegments", c.name, scale, v.name, [&]() {
+          fillSegments(segs, cbBorder, cbFill, v.flags);
+        });
+      }
+
+      // tracing the border and sorting the edges is the sequential part of the parallel fill.
+      measure("fillSegments", c.name, scale, "collectEdges", [&]() {
+        std::vector<_Edge> edges;
+        _collectEdges(segs.data(), segs.size(), edges);
+      });
+
+      // a small visible part of the path like a scrolling list on a display
+      measure("fillSegments", c.name, scale, "EdgeTrace|clip64", [&]() {
+        ClipScope clip(0, 0, 63, 63);
+        fillSegments(segs, cbBorder, cbFill, FillFlags::EdgeTrace);
+      });
+    }
+  }
+}
+
+
+void benchDrawCircle() {
+  const int16_t radiuses[] = { 10, 100, 500 };
+
+  for (int16_t r : radiuses) {
+    Point center(r + 2, r + 2);
+    measure("drawCircle", "stroke", r, "-", [&]() {
+      drawCircle(center, r, cbBorder);
+    });
+    measure("drawCircle", "filled", r, "span", [&]() {
+      drawCircle(center, r, cbBorder, cbFill);
+    });
+    // a gauge like segment over 286 degrees with the start and end point on the circle.
+    measure("drawCircle", "segment", r, "-", [&]() {
+      drawCircleSegment(center, r,
+                        Point(center.x - r * 3 / 5, center.y + r * 4 / 5),
+                        Point(center.x + r * 3 / 5, center.y + r * 4 / 5),
+                        ArcFlags::Clockwise | ArcFlags::LongPath, cbBorder);
+    });
+  }
+}
+
+
+void benchDrawText() {
+  const int16_t sizes[] = { 8, 16, 32 };
+
+  setupFont();
+  for (int16_t size : sizes) {
+    measure("drawText", "alphabet", size, "-", [&]() {
+      drawText(4, 4, size, benchText, cbText);
+    });
+  }
+}
+
+
+/// @brief capture a widget into a Sprite with the given pixel format and draw it.
+template <class TSprite>
+void benchSpriteFormat(gfxDrawPathWidget &widget, const char *item, int16_t scale, const char *variant) {
+  TSprite sprite;
+  widget.draw([&](int16_t x, int16_t y, ARGB color) {
+    sprite.drawPixel(x, y, color);
+  });
+
+  _memoryBytes = sprite.memorySize();
+  measure("Sprite::draw", item, scale, variant, [&]() {
+    sprite.draw(Point(0, 0), framePixel);
+  });
+}
+
+
+void benchSprite() {
+  for (const CorpusPath &c : corpus) {
+    for (int16_t scale : scales) {
+      gfxDrawPathWidget widget;
+      Sprite sprite;
+
+      widget.setStrokeColor(ARGB_BLACK);
+      widget.setFillColor(ARGB_SILVER);
+      widget.setPath(c.path);
+      widget.scale(scale);
+      widget.draw([&](int16_t x, int16_t y, ARGB color) {
+        sprite.drawPixel(x, y, color);
+      });
+
+      _memoryBytes = sprite.memorySize();
+      measure("Sprite::draw", c.name, scale, "-", [&]() {
+        sprite.draw(Point(0, 0), framePixel);
+      });
+
+      measure("Sprite::drawRows", c.name, scale, "-", [&]() {
+        sprite.drawRows(Point(0, 0), frameRow);
+      });
+
+      // capturing the widget into a new Sprite that grows while drawing or is reserved by the bounding box.
+      for (bool reserved : { false, true }) {
+        measure("Sprite::drawPixel", c.name, scale, (reserved ? "reserved" : "growing"), [&]() {
+          Sprite capture;
+          if (reserved) capture.reserve(widget.x_min, widget.y_min, widget.x_max - widget.x_min + 1, widget.y_max - widget.y_min + 1);
+          widget.draw([&](int16_t x, int16_t y, ARGB color) {
+            capture.drawPixel(x, y, color);
+          });
+        });
+      }
+    }
+  }
+
+  // rotated clock hands as thin sprites drawn from the full rectangle and from the compact runs.
+  const CorpusPath hands[] = {
+    { "hh", hhPath },
+    { "mm", mmPath },
+    { "ss", ssPath },
+  };
+
+  for (const CorpusPath &c : hands) {
+    gfxDrawPathWidget hand;
+    Sprite sprite;
+
+    hand.setStrokeColor(ARGB_BLACK);
+    hand.setFillColor(ARGB_BLACK);
+    hand.setPath(c.path);
+    hand.scale(200);
+    hand.rotate(40);
+    hand.move(600, 600);
+    hand.draw([&](int16_t x, int16_t y, ARGB color) {
+      sprite.drawPixel(x, y, color);
+    });
+
+    for (bool compact : { false, true }) {
+      if (compact) sprite.compact();
+      _memoryBytes = sprite.memorySize();
+      measure("Sprite::draw", c.name, 200, (compact ? "compact" : "full"), [&]() {
+        sprite.draw(Point(0, 0), framePixel);
+      });
+    }
+  }
+
+  // the pixel formats with the widget colors.
+  gfxDrawPathWidget widget;
+  widget.setStrokeColor(ARGB_BLACK);
+  widget.setFillColor(ARGB_SILVER);
+  widget.setPath(keyPath);
+  widget.scale(400);
+
+  benchSpriteFormat<SpriteRGB565>(widget, "keyPath", 400, "RGB565");
+  benchSpriteFormat<SpriteARGB4444>(widget, "keyPath", 400, "ARGB4444");
+  benchSpriteFormat<SpriteIndexed8>(widget, "keyPath", 400, "Indexed8");
+  benchSpriteFormat<SpriteMask1>(widget, "keyPath", 400, "Mask1");
+
+  // drawing the RGB565 pixels into a 16-bit framebuffer without conversion.
+  SpriteRGB565 sprite565;
+  widget.draw([&](int16_t x, int16_t y, ARGB color) {
+    sprite565.drawPixel(x, y, color);
+  });
+  std::vector<uint16_t> frame565(FRAME_WIDTH * FRAME_HEIGHT);
+  _memoryBytes = sprite565.memorySize();
+  measure("Sprite::drawNative", "keyPath", 400, "RGB565", [&]() {
+    sprite565.drawNative(Point(0, 0), [&](int16_t x, int16_t y, uint16_t p) {
+      if ((x >= 0) && (x < FRAME_WIDTH) && (y >= 0) && (y < FRAME_HEIGHT)) frame565[y * FRAME_WIDTH + x] = p;
+      if (_counting) _pixels.fetch_add(1, std::memory_order_relaxed);
+    });
+  });
+
+  measure("Sprite::drawNativeRows", "keyPath", 400, "RGB565", [&]() {
+    sprite565.drawNativeRows(Point(0, 0), [&](int16_t x, int16_t y, const uint16_t *pixels, int16_t len) {
+      if ((y >= 0) && (y < FRAME_HEIGHT) && (x >= 0) && (x + len <= FRAME_WIDTH)) {
+        memcpy(&frame565[y * FRAME_WIDTH + x], pixels, len * sizeof(uint16_t));
+      }
+      if (_counting) _pixels.fetch_add(len, std::memory_order_relaxed);
+    });
+  });
+}
+
+
+void benchSpriteDiff() {
+  // a clock face with hour and minute hands where the second hand moves by one tick.
+  gfxDrawPathWidget hands[3];
+  const char *paths[3] = { hhPath, mmPath, ssPath };
+  for (int n = 0; n < 3; n++) {
+    hands[n].setPath(paths[n]);
+    hands[n].setStrokeColor(ARGB_BLACK);
+    hands[n].setFillColor(ARGB_BLUE);
+  }
+
+  auto drawClock = [&](Sprite &frame, int16_t second) {
+    frame.reserve(0, 0, 500, 500);
+    const int16_t angles[3] = { 300, 60, (int16_t)(second * 6) };
+    for (int n = 0; n < 3; n++) {
+      hands[n].resetTransformation();
+      hands[n].scale(80);
+      hands[n].rotate(angles[n]);
+      hands[n].move(250, 250);
+      hands[n].draw([&](int16_t x, int16_t y, ARGB color) {
+        frame.drawPixel(x, y, color);
+      });
+    }
+  };
+
+  Sprite previous;
+  Sprite current;
+  drawClock(previous, 10);
+  drawClock(current, 11);
+
+  measure("Sprite::draw", "clock", 500, "full", [&]() {
+    current.draw(Point(0, 0), framePixel);
+  });
+
+  // the pixels in the dirty rectangles are counted.
+  measure("Sprite::dirtyRects", "clock", 500, "-", [&]() {
+    std::vector<BoundingBox> rects = current.dirtyRects(previous);
+    if (_counting) {
+      for (const BoundingBox &r : rects) _pixels.fetch_add((r.x1 - r.x0 + 1) * (r.y1 - r.y0 + 1), std::memory_order_relaxed);
+    }
+  });
+
+  Sprite changes;
+  measure("Sprite::diff", "clock", 500, "-", [&]() {
+    current.diff(previous, changes, ARGB_WHITE);
+  });
+
+  measure("Sprite::draw", "clock", 500, "diff", [&]() {
+    changes.draw(Point(0, 0), framePixel);
+  });
+}
+
+
+void benchBlend() {
+  const int16_t width = 1024;
+  const int16_t height = 512;
+
+  std::vector<PARGB> frame(width * height, PARGB(ARGB_SILVER));
+  std::vector<PARGB> overlay(width);
+  for (int16_t x = 0; x < width; x++) overlay[x] = PARGB(ARGB(x & 0xFF, 0x80, 0xFF - (x & 0xFF), (x * 7) & 0xFF));
+
+  // blending a row of pixels by the portable and the SIMD implementation.
+  measure("blendRow", "rows", width, "scalar", [&]() {
+    for (int16_t y = 0; y < height; y++) _blendRowScalar(&frame[y * width], overlay.data(), width);
+    if (_counting) _pixels.fetch_add(width * height, std::memory_order_relaxed);
+  });
+
+  measure("blendRow", "rows", width, blendKernel(), [&]() {
+    for (int16_t y = 0; y < height; y++) blendRow(&frame[y * width], overlay.data(), width);
+    if (_counting) _pixels.fetch_add(width * height, std::memory_order_relaxed);
+  });
+
+  // dimming a background by a translucent color.
+  PARGB dim(ARGB(0, 0, 0, 0x60));
+  measure("blendRow", "color", width, blendKernel(), [&]() {
+    for (int16_t y = 0; y < height; y++) blendRow(&frame[y * width], dim, width);
+    if (_counting) _pixels.fetch_add(width * height, std::memory_order_relaxed);
+  });
+
+  // blending the rows of a translucent widget captured in a Sprite.
+  gfxDrawPathWidget widget;
+  SpritePARGB sprite;
+  widget.setStrokeColor(ARGB_BLACK);
+  widget.setFillColor(ARGB(0x00, 0x00, 0xFF, 0x80));
+  widget.setPath(keyPath);
+  widget.scale(200);
+  widget.draw([&](int16_t x, int16_t y, ARGB color) {
+    sprite.drawPixel(x, y, color);
+  });
+
+  ClipScope clip(0, 0, width - 1, height - 1);
+  measure("Sprite::drawNativeRows", "keyPath", 200, "blend", [&]() {
+    sprite.drawNativeRows(Point(0, 0), [&](int16_t x, int16_t y, const PARGB *pixels, int16_t len) {
+      blendRow(&frame[y * width + x], pixels, len);
+      if (_counting) _pixels.fetch_add(len, std::memory_order_relaxed);
+    });
+  });
+}
+
+
+void benchPathWidget() {
+  for (const CorpusPath &c : corpus) {
+    for (int16_t scale : scales) {
+      gfxDrawPathWidget widget;
+      widget.setStrokeColor(ARGB_BLACK);
+      widget.setFillColor(ARGB_SILVER);
+      widget.setPath(c.path);
+
+      int16_t angle = 0;
+      measure("gfxDrawPathWidget", c.name, scale, "rotate", [&]() {
+        widget.resetTransformation();
+        widget.scale(scale);
+        widget.rotate(angle, 60, 60);
+        widget.move(60 * scale / 100, 60 * scale / 100);
+        widget.draw(framePixel);
+        angle = (angle + 7) % 360;
+      });
+    }
+  }
+
+  // unchanged widgets are drawn using the cached transformed path or the span cache.
+  for (const CorpusPath &c : corpus) {
+    for (int16_t scale : scales) {
+      for (bool spanCache : { false, true }) {
+        gfxDrawPathWidget widget;
+        widget.setStrokeColor(ARGB_BLACK);
+        widget.setFillColor(ARGB_SILVER);
+        widget.setPath(c.path);
+        widget.setSpanCache(spanCache);
+
+        measure("gfxDrawPathWidget", c.name, scale, (spanCache ? "static+spans" : "static"), [&]() {
+          widget.resetTransformation();
+          widget.scale(scale);
+          widget.draw(framePixel);
+        });
+      }
+    }
+  }
+
+  // widgets scrolled out of the visible area are culled by the bounding box.
+  for (const CorpusPath &c : corpus) {
+    gfxDrawPathWidget widget;
+    widget.setStrokeColor(ARGB_BLACK);
+    widget.setFillColor(ARGB_SILVER);
+    widget.setPath(c.path);
+
+    measure("gfxDrawPathWidget", c.name, 100, "offscreen", [&]() {
+      ClipScope clip(0, 0, 239, 239);
+      widget.resetTransformation();
+      widget.move(0, 1000);
+      widget.draw(framePixel);
+    });
+  }
+
+  // clock with marks and hands like in the moonclock example.
+  struct ClockPart {
+    const char *name;
+    const char *path;
+    ARGB stroke;
+    ARGB fill;
+  };
+
+  const ClockPart parts[] = {
+    { "mark05", mark05Path, ARGB_TRANSPARENT, ARGB_BLACK },
+    { "hh", hhPath, ARGB_BLACK, ARGB_BLACK },
+    { "mm", mmPath, ARGB_TRANSPARENT, ARGB_BLUE },
+    { "ss", ssPath, ARGB_RED, ARGB_TRANSPARENT },
+  };
+
+  for (int16_t radius : { 120, 500 }) {
+    for (const ClockPart &p : parts) {
+      gfxDrawPathWidget hand;
+      hand.setPath(p.path);
+      hand.setStrokeColor(p.stroke);
+      hand.setFillColor(p.fill);
+
+      int16_t angle = 0;
+      measure("gfxDrawPathWidget", p.name, radius, "clock", [&]() {
+        hand.resetTransformation();
+        hand.scale(radius * 100 / 256);
+        hand.rotate(angle);
+        hand.move(radius + 8, radius + 8);
+        hand.draw(framePixel);
+        angle = (angle + 6) % 360;
+      });
+    }
+  }
+}
+
+
+void benchGaugeWidget() {
+  for (uint16_t w : { 160, 800 }) {
+    // Gauge with default segment, no scale, standard pointer
+    gfxDrawGaugeConfig conf1 = {
+      .x = 10,
+      .y = 10,
+      .w = w,
+      .h = w
+    };
+
+    // Gauge with multiple segments and scale, custom pointer
+    gfxDrawGaugeConfig conf2 = {
+      .x = 10,
+      .y = 10,
+      .w = w,
+      .h = w,
+      .pointerColor = ARGB_GREEN,
+      .segmentColor = ARGB_GRAY,
+      .minValue = 0,
+      .maxValue = 100,
+      .minAngle = 30,
+      .maxAngle = 360 - 30,
+      .scaleRadius = 95,
+      .scaleSteps = 10,
+      .pointerPath = "M-50,-100 L-50,800 L0,850 L50,800 L50,-100 L0,0 Z"
+    };
+
+    // half gauge with segments and scale, short custom pointer
+    gfxDrawGaugeConfig conf3 = {
+      .x = 10,
+      .y = 10,
+      .w = w,
+      .h = w,
+      .minAngle = 0,
+      .maxAngle = 180,
+      .scaleWidth = 10,
+      .scaleSteps = 20,
+      .pointerPath = "M-70,550 L0,850 L70 550 Z"
+    };
+
+    gfxDrawGaugeWidget g1(&conf1);
+    g1.setValue(70);
+    measure("gfxDrawGaugeWidget", "default", w, "-", [&]() {
+      g1.draw(framePixel);
+    });
+
+    gfxDrawGaugeWidget g2(&conf2);
+    g2.addSegment(0, 16, 0xff8080ff);
+    g2.addSegment(16, 24, 0xff60ff60);
+    g2.addSegment(45, 80, 0xffff8080);
+    g2.addSegment(80, 100, 0xffff2222);
+    g2.setValue(32);
+    measure("gfxDrawGaugeWidget", "segments", w, "-", [&]() {
+      g2.draw(framePixel);
+    });
+
+    gfxDrawGaugeWidget g3(&conf3);
+    g3.addSegment(0, 25, 0xFFFF8888);
+    g3.addSegment(25, 45, 0xFFFFFF88);
+    g3.addSegment(45, 75, 0xFF88FF88);
+    g3.addSegment(75, 100, 0xFFFF4444);
+    g3.setValue(55);
+    measure("gfxDrawGaugeWidget", "half", w, "-", [&]() {
+      g3.draw(framePixel);
+    });
+  }
+}
+
+
+/// @brief the arc, angle and rotation calculations that use fixed-point arithmetics with GFXDRAW_NO_FLOAT.
+/// Every operation calls the function 64 times.
+void benchMath() {
+  volatile int32_t sink = 0;
+
+  measure("math", "arcCenter", 0, "-", [&]() {
+    for (int16_t n = 0; n < 64; n++) {
+      int16_t rx = 40 + n, ry = 20 + n;
+      int32_t cx256, cy256;
+      arcCenter(10, 20 + n, 90, 60 - n, rx, ry, (n * 7) % 360, n & 3, cx256, cy256);
+      sink = sink + cx256 + cy256;
+    }
+  });
+
+  measure("math", "vectorAngle", 0, "-", [&]() {
+    for (int16_t n = 0; n < 64; n++) {
+      sink = sink + vectorAngle(100 - 3 * n, 2 * n - 50);
+    }
+  });
+
+  std::vector<Segment> keySegments = parsePath(keyPath);
+  measure("math", "rotateSegments", 0, "-", [&]() {
+    for (int16_t n = 0; n < 64; n++) {
+      rotateSegments(keySegments, 1);
+    }
+  });
+
+  gfxDrawGaugeConfig conf = { .x = 10, .y = 10, .w = 160, .h = 160 };
+  gfxDrawGaugeWidget gauge(&conf);
+  measure("math", "gaugeSetValue", 0, "-", [&]() {
+    for (int16_t n = 0; n < 64; n++) {
+      gauge.setValue(n);
+    }
+  });
+
+  // ellipse arcs are flattened with angles for the outline of a stroke.
+  for (int16_t scale : scales) {
+    std::vector<Segment> segs = scaledPath(SmileyArcPath, scale);
+    measure("math", "SmileyArcPath", scale, "width5", [&]() {
+      drawSegments(segs, 5, cbFill);
+    });
+  }
+}
+
+
+// ===== Checks =====
+
+/// @brief calls of the border callback (+1) and the fill callback (+16) for every pixel of the frame.
+static std::atomic<uint8_t> *_hits;
+
+#define HIT_BORDER 1
+#define HIT_FILL 16
+
+static void hitBorder(int16_t x, int16_t y) {
+  _hits[y * FRAME_WIDTH + x].fetch_add(HIT_BORDER, std::memory_order_relaxed);
+  _pixels.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void hitSpan(int16_t x0, int16_t x1, int16_t y) {
+  for (int16_t x = x0; x <= x1; x++) { _hits[y * FRAME_WIDTH + x].fetch_add(HIT_FILL, std::memory_order_relaxed); }
+  _pixels.fetch_add(x1 - x0 + 1, std::memory_order_relaxed);
+}
+
+/// @brief Check that fillSegments passes every pixel only once to one of the callbacks and that all variants draw
+/// the same pixels as the serial fill without clipping.
+/// For every path and fill rule the pixels of the serial fill are recorded as a reference.  Every variant must draw
+/// the same pixels: with the parallel fill, without a border callback where the border pixels are passed to the fill
+/// callback and inside a clip rectangle.  The NonZero rule must draw the same border and at least the pixels of the
+/// EvenOdd rule and the same pixels for paths without overlapping sub-paths.
+/// @return number of failed checks.
+int checkFillSegments() {
+  struct Variant {
+    const char *name;
+    FillFlags flags;
+  };
+
+  const Variant variants[] = {
+    { "EdgeTrace", FillFlags::EdgeTrace },
+    { "EdgeTrace|NonZero", FillFlags::EdgeTrace | FillFlags::NonZero },
+    { "EdgeTrace|Parallel", FillFlags::EdgeTrace | FillFlags::Parallel },
+    { "EdgeTrace|NonZero|Parallel", FillFlags::EdgeTrace | FillFlags::NonZero | FillFlags::Parallel },
+  };
+
+  struct CheckPath {
+    const char *name;
+    const char *path;
+    bool overlapping;  // the sub-paths overlap with the same direction so NonZero draws more pixels.
+    uint32_t pixels;   // number of pixels drawn with the EvenOdd rule at 100% or 0 when not known.
+  };
+
+  const CheckPath checkPaths[] = {
+    { "square", "M10 10 h50 v50 h-50 z", false, 51 * 51 },
+    { "squares", "M10 10 h50 v50 h-50 z M40 40 h50 v50 h-50 z", true, 2 * 51 * 51 - 21 * 21 - 19 * 19 },
+    { "ring", "M60 10 a50 50 0 0 1 0 100 a50 50 0 0 1 0 -100z M60 30 a30 30 0 0 0 0 60 a30 30 0 0 0 0 -60z", false, 0 },
+    { "swordPath", swordPath, false, 0 },
+    { "keyPath", keyPath, false, 0 },
+    { "SmilieCurvePath", SmilieCurvePath, false, 0 },
+    { "SmileyArcPath", SmileyArcPath, true, 0 },
+  };
+
+  const ClipRect clips[] = {
+    { 0, 0, FRAME_WIDTH - 1, FRAME_HEIGHT - 1 },
+    { 20, 20, 83, 83 },
+  };
+
+  int failed = 0;
+  _hits = new std::atomic<uint8_t>[FRAME_WIDTH * FRAME_HEIGHT];
+  for (size_t n = 0; n < FRAME_WIDTH * FRAME_HEIGHT; n++) { _hits[n] = 0; }
+
+  for (const CheckPath &c : checkPaths) {
+    for (int16_t scale : scales) {
+      std::vector<Segment> segs = scaledPath(c.path, scale);
+
+      // only the pixels inside the bounding box are compared, the pixels outside are found by the count.
+      BoundingBox box = boundingBox(segs);
+      if (box.x0 < 0) box.x0 = 0;
+      if (box.y0 < 0) box.y0 = 0;
+      if (box.x1 >= FRAME_WIDTH) box.x1 = FRAME_WIDTH - 1;
+      if (box.y1 >= FRAME_HEIGHT) box.y1 = FRAME_HEIGHT - 1;
+      int32_t boxWidth = box.x1 - box.x0 + 1;
+      std::vector<uint8_t> reference[2];
+
+      // draw a variant and compare the pixels in the box with the expected pixels, the hits are cleared afterwards.
+      auto run = [&](const Variant &v, const ClipRect &clip, bool withBorder, const std::vector<uint8_t> *expected,
+                     std::vector<uint8_t> &result) {
+        _pixels = 0;
+        {
+          ClipScope scope(clip.x0, clip.y0, clip.x1, clip.y1);
+          if (withBorder) {
+            fillSegments(segs, hitBorder, hitSpan, v.flags);
+          } else {
+            fillSegments(segs, nullptr, hitSpan, v.flags);
+          }
+        }
+
+        uint64_t inBox = 0;
+        uint64_t duplicates = 0;
+        uint64_t differences = 0;
+        result.resize((size_t)boxWidth * (box.y1 - box.y0 + 1));
+        for (int16_t y = box.y0; y <= box.y1; y++) {
+          for (int16_t x = box.x0; x <= box.x1; x++) {
+            uint8_t hit = _hits[y * FRAME_WIDTH + x];
+            _hits[y * FRAME_WIDTH + x] = 0;
+            size_t n = (size_t)(y - box.y0) * boxWidth + (x - box.x0);
+            result[n] = hit;
+            if (hit) inBox++;
+            if ((hit != 0) && (hit != HIT_BORDER) && (hit != HIT_FILL)) duplicates++;
+            if (expected) {
+              uint8_t e = (clip.contains(x, y) ? (*expected)[n] : 0);
+              if ((!withBorder) && (e)) e = HIT_FILL;
+              if (hit != e) differences++;
+            }
+          }
+        }
+        uint64_t pixels = _pixels;
+        if (pixels != inBox) differences += (pixels > inBox ? pixels - inBox : inBox - pixels);
+
+        printf("{\"check\":\"fillSegments\",\"item\":\"%s\",\"scale\":%d,\"variant\":\"%s\",\"clip\":%d,"
+               "\"border\":%d,\"pixels\":%llu,\"duplicates\":%llu,\"differences\":%llu}\n",
+               c.name, scale, v.name, clip.x1, withBorder, (unsigned long long)pixels,
+               (unsigned long long)duplicates, (unsigned long long)differences);
+        if (duplicates || differences || ((!expected) && (pixels == 0))) failed++;
+        return (pixels);
+      };
+
+      // the serial fill without clipping with both rules is the reference for all variants.
+      uint64_t pixels[2];
+      for (int rule = 0; rule <= 1; rule++) {
+        pixels[rule] = run(variants[rule], clips[0], true, nullptr, reference[rule]);
+      }
+
+      if ((scale == 100) && (c.pixels) && (pixels[0] != c.pixels)) {
+        fprintf(stderr, "%s: %llu pixels instead of %u.\n", c.name, (unsigned long long)pixels[0], c.pixels);
+        failed++;
+      }
+
+      // the NonZero rule has the same border and fills at least the pixels of the EvenOdd rule.
+      uint64_t ruleDifferences = 0;
+      for (size_t n = 0; n < reference[0].size(); n++) {
+        uint8_t evenOdd = reference[0][n];
+        uint8_t nonZero = reference[1][n];
+        if ((evenOdd == HIT_BORDER) != (nonZero == HIT_BORDER)) ruleDifferences++;
+        if ((evenOdd == HIT_FILL) && (nonZero != HIT_FILL)) ruleDifferences++;
+      }
+      if ((ruleDifferences) || ((pixels[1] > pixels[0]) != c.overlapping)) {
+        fprintf(stderr, "%s/%d: NonZero draws %llu pixels and EvenOdd %llu pixels with %llu differences.\n",
+                c.name, scale, (unsigned long long)pixels[1], (unsigned long long)pixels[0],
+                (unsigned long long)ruleDifferences);
+        failed++;
+      }
+
+      std::vector<uint8_t> result;
+      for (const Variant &v : variants) {
+        const std::vector<uint8_t> *expected = &reference[(v.flags & FillFlags::NonZero) ? 1 : 0];
+        for (const ClipRect &clip : clips) {
+          for (int withBorder = 0; withBorder <= 1; withBorder++) {
+            run(v, clip, withBorder, expected, result);
+          }
+        }
+      }
+    }
+  }
+
+  delete[] _hits;
+  return (failed);
+}  // checkFillSegments()
+
+
+/// @brief Check that threads drawing at the same time in their own ClipScope use their own clip rectangle.
+/// @return number of failed checks.
+int checkClipThreads() {
+  int failed = 0;
+#ifdef GFXDRAW_THREADS
+  std::vector<Segment> segs = scaledPath(keyPath, 100);
+  const ClipRect clips[2] = { { 0, 0, 119, 255 }, { 120, 0, 255, 255 } };
+
+  // the pixels inside the clip rectangle of every thread drawn without other threads.
+  uint64_t expected[2] = { 0, 0 };
+  for (int t = 0; t < 2; t++) {
+    ClipScope scope(clips[t].x0, clips[t].y0, clips[t].x1, clips[t].y1);
+    fillSegments(segs, nullptr, [&](int16_t x0, int16_t x1, int16_t y) { expected[t] += x1 - x0 + 1; });
+  }
+
+  uint64_t pixels[2] = { 0, 0 };
+  uint64_t outside[2] = { 0, 0 };
+  std::thread threads[2];
+  for (int t = 0; t < 2; t++) {
+    threads[t] = std::thread([&, t]() {
+      ClipScope scope(clips[t].x0, clips[t].y0, clips[t].x1, clips[t].y1);
+      for (int n = 0; n < 200; n++) {
+        fillSegments(segs, nullptr, [&](int16_t x0, int16_t x1, int16_t y) {
+          pixels[t] += x1 - x0 + 1;
+          if ((!clips[t].contains(x0, y)) || (!clips[t].contains(x1, y))) outside[t]++;
+        });
+      }
+    });
+  }
+  for (std::thread &t : threads) t.join();
+
+  for (int t = 0; t < 2; t++) {
+    printf("{\"check\":\"ClipScope\",\"item\":\"keyPath\",\"thread\":%d,\"pixels\":%llu,\"expected\":%llu,"
+           "\"outside\":%llu}\n",
+           t, (unsigned long long)pixels[t], (unsigned long long)(200 * expected[t]), (unsigned long long)outside[t]);
+    if ((pixels[t] != 200 * expected[t]) || (outside[t]) || (expected[t] == 0)) failed++;
+  }
+#endif
+  return (failed);
+}  // checkClipThreads()
+
+
+/// @brief Compare 2 Sprites by dirtyRects() and diff() and check the number and color of the changed pixels.
+/// @return number of failed checks.
+template <class TSprite>
+int checkSpriteDiff(const char *name, const TSprite &current, const TSprite &previous, uint32_t expected, ARGB color) {
+  std::vector<BoundingBox> rects = current.dirtyRects(previous);
+
+  TSprite changes;
+  uint32_t pixels = 0;
+  uint32_t wrong = 0;
+  current.diff(previous, changes, ARGB_WHITE);
+  changes.draw(Point(0, 0), [&](int16_t, int16_t, ARGB c) {
+    pixels++;
+    if (c.raw != color.raw) wrong++;
+  });
+
+  printf("{\"check\":\"Sprite::diff\",\"item\":\"%s\",\"rects\":%u,\"pixels\":%u,\"expected\":%u,\"wrongColors\":%u}\n",
+         name, (unsigned)rects.size(), pixels, expected, wrong);
+  return ((rects.size() != (expected ? 1u : 0u)) || (pixels != expected) || (wrong)) ? 1 : 0;
+}  // checkSpriteDiff()
+
+
+/// @brief Check that dirtyRects() and diff() compare the colors of the pixels and not the stored values.
+/// @return number of failed checks.
+int checkSpriteDiffs() {
+  int failed = 0;
+
+  {
+    // the same index is another color in the palettes.
+    SpriteIndexed8 previous, current;
+    previous.drawPixel(5, 5, ARGB_RED);
+    current.drawPixel(5, 5, ARGB_BLUE);
+    failed += checkSpriteDiff("Indexed8/samePixel", current, previous, 1, ARGB_BLUE);
+  }
+
+  {
+    // the same colors use other indices in the palettes.
+    SpriteIndexed8 previous, current;
+    previous.drawPixel(0, 0, ARGB_RED);
+    previous.drawPixel(5, 5, ARGB_BLUE);
+    current.drawPixel(5, 5, ARGB_BLUE);
+    current.drawPixel(0, 0, ARGB_RED);
+    failed += checkSpriteDiff("Indexed8/sameColors", current, previous, 0, ARGB_BLUE);
+  }
+
+  {
+    // a palette extended by new colors.
+    SpriteIndexed8 previous, current;
+    previous.drawPixel(0, 0, ARGB_RED);
+    current.drawPixel(0, 0, ARGB_RED);
+    current.drawPixel(5, 5, ARGB_BLUE);
+    failed += checkSpriteDiff("Indexed8/morePixels", current, previous, 1, ARGB_BLUE);
+  }
+
+  {
+    // the same mask with another color.
+    SpriteMask1 previous, current;
+    previous.format().color = ARGB_RED;
+    current.format().color = ARGB_BLUE;
+    previous.drawPixel(5, 5, ARGB_BLACK);
+    current.drawPixel(5, 5, ARGB_BLACK);
+    failed += checkSpriteDiff("Mask1/color", current, previous, 1, ARGB_BLUE);
+  }
+
+  {
+    // transparent pixels with another color are not changed.
+    Sprite previous, current;
+    previous.reserve(0, 0, 10, 10);
+    current.reserve(0, 0, 10, 10);
+    previous.drawPixel(5, 5, ARGB(0xFF, 0x00, 0x00, 0x00));
+    failed += checkSpriteDiff("ARGB/transparent", current, previous, 0, ARGB_BLUE);
+  }
+
+  {
+    Sprite previous, current;
+    previous.drawPixel(5, 5, ARGB_RED);
+    current.drawPixel(5, 5, ARGB_BLUE);
+    failed += checkSpriteDiff("ARGB/color", current, previous, 1, ARGB_BLUE);
+  }
+
+  return (failed);
+}  // checkSpriteDiffs()
+
+
+// The pixels drawn by a Sprite with the position in the key and the color as value.
+typedef std::map<uint32_t, uint32_t> SpritePixels;
+
+static uint32_t _random = 1;
+
+static uint32_t nextRandom() {
+  _random = _random * 1103515245 + 12345;
+  return (_random >> 8);
+}
+
+static void addPixel(SpritePixels &pixels, int16_t x, int16_t y, ARGB color, uint32_t &twice) {
+  if (!pixels.emplace(((uint32_t)(uint16_t)y << 16) | (uint16_t)x, color.raw).second) twice++;
+}
+
+// count the pixels that are missing in one of the maps or have another color.
+static uint32_t countDifferences(const SpritePixels &a, const SpritePixels &b) {
+  uint32_t count = 0;
+  for (const auto &p : a) {
+    auto f = b.find(p.first);
+    if ((f == b.end()) || (f->second != p.second)) count++;
+  }
+  for (const auto &p : b) {
+    if (a.find(p.first) == a.end()) count++;
+  }
+  return (count);
+}
+
+
+/// @brief Compare the pixels of all draw functions of a Sprite with the expected pixels.
+/// @return number of failed checks.
+template <class TSprite>
+int checkSpriteDraw(const char *name, const char *variant, TSprite &sprite, const SpritePixels &expected) {
+  typedef typename TSprite::Pixel Pixel;
+  const Point pos(3, -2);
+  const char *functions[4] = { "draw", "drawRows", "drawNative", "drawNativeRows" };
+  SpritePixels pixels[4];
+  uint32_t twice[4] = { 0, 0, 0, 0 };
+
+  sprite.draw(pos, [&](int16_t x, int16_t y, ARGB color) {
+    addPixel(pixels[0], x - pos.x, y - pos.y, color, twice[0]);
+  });
+  sprite.drawRows(pos, [&](int16_t x, int16_t y, const ARGB *row, int16_t len) {
+    for (int16_t i = 0; i < len; i++) addPixel(pixels[1], x + i - pos.x, y - pos.y, row[i], twice[1]);
+  });
+  sprite.drawNative(pos, [&](int16_t x, int16_t y, Pixel p) {
+    addPixel(pixels[2], x - pos.x, y - pos.y, sprite.format().toARGB(p), twice[2]);
+  });
+  sprite.drawNativeRows(pos, [&](int16_t x, int16_t y, const Pixel *row, int16_t len) {
+    for (int16_t i = 0; i < len; i++) {
+      addPixel(pixels[3], x + i - pos.x, y - pos.y, sprite.format().toARGB(row[i]), twice[3]);
+    }
+  });
+
+  int failed = 0;
+  for (int f = 0; f < 4; f++) {
+    uint32_t differences = countDifferences(pixels[f], expected);
+    printf("{\"check\":\"Sprite\",\"item\":\"%s\",\"variant\":\"%s/%s\",\"pixels\":%u,\"expected\":%u,"
+           "\"differences\":%u,\"twice\":%u}\n",
+           name, variant, functions[f], (unsigned)pixels[f].size(), (unsigned)expected.size(), differences, twice[f]);
+    if ((differences) || (twice[f]) || (expected.empty())) failed++;
+  }
+  return (failed);
+}  // checkSpriteDraw()
+
+
+/// @brief Check the pixels of a Sprite with random pixels in the full and the compact form, after mapping colors and
+/// after drawing into the compact Sprite.
+/// @return number of failed checks.
+template <class TSprite>
+int checkSpriteFormat(const char *name) {
+  TSprite sprite;
+  std::vector<std::pair<Point, ARGB>> drawn;
+
+  // random colors with all alpha ranges, the RGB565 transparent key color and more colors than a palette can hold.
+  const uint8_t alphas[5] = { 0xFF, 0xFF, 0x80, 0x08, 0x00 };
+  for (int n = 0; n < 1200; n++) {
+    Point p((int16_t)(nextRandom() % 40) - 5, (int16_t)(nextRandom() % 30) + 7);
+    uint32_t r = nextRandom();
+    ARGB color((r >> 16) & 0xFF, (r >> 8) & 0xFF, r & 0xFF, alphas[nextRandom() % 5]);
+    if (nextRandom() % 20 == 0) color = ARGB(0xFF, 0x00, 0xFF);
+    sprite.drawPixel(p.x, p.y, color);
+    drawn.push_back({ p, color });
+  }
+
+  // the last color of every pixel converted like the Sprite does, the palette is not changed any more.
+  SpritePixels expected;
+  for (auto &d : drawn) {
+    auto f = sprite.format();
+    typename TSprite::Pixel p = f.fromARGB(d.second);
+    uint32_t key = ((uint32_t)(uint16_t)d.first.y << 16) | (uint16_t)d.first.x;
+    if (f.isVisible(p)) {
+      expected[key] = f.toARGB(p).raw;
+    } else {
+      expected.erase(key);
+    }
+  }
+
+  int failed = checkSpriteDraw(name, "full", sprite, expected);
+
+  TSprite compact = sprite;
+  compact.compact();
+  failed += checkSpriteDraw(name, "compact", compact, expected);
+
+  // mapping the visible colors keeps the Sprite compact.
+  const ARGB oldColor(expected.begin()->second);
+  sprite.mapColor(oldColor, ARGB_BLUE);
+  compact.mapColor(oldColor, ARGB_BLUE);
+  sprite.mapColor([](ARGB c) { return (ARGB(0xFF - c.Red, 0xFF - c.Green, 0xFF - c.Blue, c.Alpha)); });
+  compact.mapColor([](ARGB c) { return (ARGB(0xFF - c.Red, 0xFF - c.Green, 0xFF - c.Blue, c.Alpha)); });
+  if (!compact.isCompact()) failed++;
+
+  SpritePixels mapped;
+  uint32_t twice = 0;
+  sprite.draw(Point(0, 0), [&](int16_t x, int16_t y, ARGB color) { addPixel(mapped, x, y, color, twice); });
+  failed += checkSpriteDraw(name, "compact/mapColor", compact, mapped);
+
+  // drawing into a compact Sprite expands it again.
+  sprite.drawPixel(-20, 50, ARGB_GREEN);
+  compact.drawPixel(-20, 50, ARGB_GREEN);
+  if (compact.isCompact()) failed++;
+
+  SpritePixels extended;
+  sprite.draw(Point(0, 0), [&](int16_t x, int16_t y, ARGB color) { addPixel(extended, x, y, color, twice); });
+  failed += checkSpriteDraw(name, "compact/drawPixel", compact, extended);
+  return (failed);
+}  // checkSpriteFormat()
+
+
+/// @brief Check that a Sprite draws one pixel with the expected color.
+/// @return number of failed checks.
+template <class TSprite>
+int checkSpritePixel(const char *name, TSprite &sprite, ARGB expected) {
+  uint32_t pixels = 0;
+  ARGB color;
+  sprite.draw(Point(0, 0), [&](int16_t, int16_t, ARGB c) {
+    pixels++;
+    color = c;
+  });
+  printf("{\"check\":\"Sprite\",\"item\":\"%s\",\"pixels\":%u,\"color\":\"%08x\",\"expected\":\"%08x\"}\n",
+         name, pixels, (unsigned)color.raw, (unsigned)expected.raw);
+  return (((pixels != 1) || (color.raw != expected.raw)) ? 1 : 0);
+}  // checkSpritePixel()
+
+
+/// @brief Check the conversions of the pixel formats and that all draw functions and the compact form of a Sprite
+/// draw the same pixels.
+/// @return number of failed checks.
+int checkSprites() {
+  int failed = 0;
+
+  failed += checkSpriteFormat<Sprite>("ARGB");
+  failed += checkSpriteFormat<SpritePARGB>("PARGB");
+  failed += checkSpriteFormat<SpriteRGB565>("RGB565");
+  failed += checkSpriteFormat<SpriteARGB4444>("ARGB4444");
+  failed += checkSpriteFormat<SpriteIndexed8>("Indexed8");
+  failed += checkSpriteFormat<SpriteMask1>("Mask1");
+
+  {
+    // an opaque color with the value of the transparent key is changed in the lowest green bit.
+    SpriteRGB565 sprite;
+    sprite.drawPixel(0, 0, ARGB(0xFF, 0x00, 0xFF));
+    failed += checkSpritePixel("RGB565/keyColor", sprite, ARGB(0xFF, 0x04, 0xFF));
+  }
+
+  {
+    // a small alpha value is not rounded down to transparent.
+    SpriteARGB4444 sprite;
+    sprite.drawPixel(0, 0, ARGB(0x10, 0x20, 0x30, 0x08));
+    failed += checkSpritePixel("ARGB4444/alpha", sprite, ARGB(0x11, 0x22, 0x33, 0x11));
+  }
+
+  {
+    // a full palette takes the nearest color and mapColor doesn't change the palette for an unknown color.
+    SpriteIndexed8 sprite;
+    for (int n = 1; n <= 255; n++) sprite.drawPixel(0, 0, ARGB(n, 0, 0));
+    sprite.drawPixel(0, 0, ARGB(100, 3, 0));
+    sprite.mapColor(ARGB(0, 0, 200), ARGB_BLUE);
+    failed += checkSpritePixel("Indexed8/fullPalette", sprite, ARGB(100, 0, 0));
+    if (sprite.format().palette.size() != 256) failed++;
+  }
+
+  return (failed);
+}  // checkSprites()
+
+
+// A path with a smooth curve, an arc and a closing segment parsed at compile time.
+constexpr const char *constexprPath = "M10 10c0 5 5 10 10 10s10-5 10-10A10 10 0 0 1 10 10Z";
+static constexpr auto constexprSegments = GFXDRAW_PATH(constexprPath);
+
+static_assert(constexprSegments.size() == 5, "GFXDRAW_PATH: segment count");
+static_assert(constexprSegments[0].type == Segment::Move, "GFXDRAW_PATH: M");
+static_assert((constexprSegments[1].type == Segment::Curve) && (constexprSegments[1].p[2] == 15)
+                && (constexprSegments[1].p[3] == 20) && (constexprSegments[1].p[4] == 20),
+              "GFXDRAW_PATH: c");
+static_assert((constexprSegments[2].type == Segment::Curve) && (constexprSegments[2].p[0] == 25)
+                && (constexprSegments[2].p[1] == 20) && (constexprSegments[2].p[4] == 30)
+                && (constexprSegments[2].p[5] == 10),
+              "GFXDRAW_PATH: s reflects the control point");
+static_assert((constexprSegments[3].type == Segment::Arc) && (constexprSegments[3].p[0] == 10)
+                && (constexprSegments[3].p[4] == 10) && (constexprSegments[3].p[5] == 10),
+              "GFXDRAW_PATH: A");
+static_assert(constexprSegments[4].type == Segment::Close, "GFXDRAW_PATH: Z");
+
+
+/// @brief Compare the segments parsed at compile time with the segments of parsePath().
+/// @return number of failed checks.
+template <size_t N>
+int checkPathArray(const char *name, const std::array<Segment, N> &segments, const char *pathText) {
+  std::vector<Segment> expected = parsePath(pathText);
+
+  uint32_t differences = 0;
+  for (size_t n = 0; n < N; n++) {
+    if ((n >= expected.size()) || (segments[n].type != expected[n].type)) {
+      differences++;
+    } else {
+      for (int i = 0; i < 6; i++) {
+        if (segments[n].p[i] != expected[n].p[i]) differences++;
+      }
+    }
+  }
+
+  printf("{\"check\":\"GFXDRAW_PATH\",\"item\":\"%s\",\"segments\":%u,\"expected\":%u,\"differences\":%u}\n",
+         name, (unsigned)N, (unsigned)expected.size(), differences);
+  return (((N != expected.size()) || (differences)) ? 1 : 0);
+}  // checkPathArray()
+
+
+/// @brief Check that GFXDRAW_PATH creates the same segments as parsePath().
+/// @return number of failed checks.
+int checkPathArrays() {
+  static constexpr auto swordSegments = GFXDRAW_PATH(swordPath);
+  static constexpr auto keySegments = GFXDRAW_PATH(keyPath);
+
+  int failed = checkPathArray("constexprPath", constexprSegments, constexprPath);
+  failed += checkPathArray("swordPath", swordSegments, swordPath);
+  failed += checkPathArray("keyPath", keySegments, keyPath);
+  return (failed);
+}  // checkPathArrays()
+
+
+int main(int argc, char *argv[]) {
+  bool check = false;
+
+  for (int n = 1; n < argc; n++) {
+    if (strcmp(argv[n], "--quick") == 0) {
+      _minTime = 1000000;
+    } else if ((strcmp(argv[n], "--filter") == 0) && (n + 1 < argc)) {
+      _filter = argv[++n];
+    } else if (strcmp(argv[n], "--check") == 0) {
+      check = true;
+    } else {
+      fprintf(stderr, "usage: %s [--quick] [--filter <text>] [--check]\n", argv[0]);
+      return (1);
+    }
+  }
+
+  if (check) {
+    int failed = checkFillSegments();
+    failed += checkClipThreads();
+    failed += checkSpriteDiffs();
+    failed += checkSprites();
+    failed += checkPathArrays();
+    fprintf(stderr, "%d checks failed.\n", failed);
+    return (failed ? 1 : 0);
+  }
+
+  _frame = (ARGB *)calloc(FRAME_WIDTH * FRAME_HEIGHT, sizeof(ARGB));
+  if (!_frame) return (1);
+
+  benchParsePath();
+  benchDrawSegments();
+  benchFillSegments();
+  benchDrawCircle();
+  benchDrawText();
+  benchSprite();
+  benchSpriteDiff();
+  benchBlend();
+  benchPathWidget();
+  benchGaugeWidget();
+  benchMath();
+
+  free(_frame);
+  return (0);
+}
+
+// End.
@@ -142,6 +142,20 @@ const char *keyPath =
 
 
 
+// draw a digit segment parsed at compile time at the position x, y.
+template<size_t N>
+void drawDigitSegment(const std::array<gfxDraw::Segment, N> &segments, uint16_t x, uint16_t y,
+                      gfxDraw::fSetPixel cbBorder, gfxDraw::fSetPixel cbFill) {
+  std::array<gfxDraw::Segment, N> segs = segments;
+  gfxDraw::moveSegments(segs.data(), N, x, y);
+  if (cbFill) {
+    gfxDraw::fillSegments(segs.data(), N, cbBorder, cbFill);
+  } else {
+    gfxDraw::drawSegments(segs.data(), N, cbBorder);
+  }
+}
+
+
 void drawDigits14(int n, uint16_t x, uint16_t y, gfxDraw::fSetPixel cbBorder, gfxDraw::fSetPixel cbFill = nullptr) {
 
   uint16_t SD[10] = {
@@ -158,22 +172,38 @@ void drawDigits14(int n, uint16_t x, uint16_t y, gfxDraw::fSetPixel cbBorder, gf
   };
   uint16_t sd = SD[n % 10];
 
+  // the segments are parsed at compile time.
   // clang-format off
-  if (sd & 0b0000000000000001) gfxDraw::pathByText("M 10 1h49l3 3l-5 5h-45l-5 -5Z",       x, y, 100, cbBorder, cbFill);
-  if (sd & 0b0000000000000010) gfxDraw::pathByText("M1 10v42h4l5 -5v-36l-5 -5Z",          x, y, 100, cbBorder, cbFill);
-  if (sd & 0b0000000000000100) gfxDraw::pathByText("M13 12h4l10 20v15h-3l-11 -23z",       x, y, 100, cbBorder, cbFill);
-  if (sd & 0b0000000000001000) gfxDraw::pathByText("M30 12h9v34l-4 4h-1l-4 -4z",          x, y, 100, cbBorder, cbFill);
-  if (sd & 0b0000000000010000) gfxDraw::pathByText("M56 12h-4l-10 20v15h3l11 -23z",       x, y, 100, cbBorder, cbFill);
-  if (sd & 0b0000000000100000) gfxDraw::pathByText("M68 10v42l-4 0l-5 -5v-36 l5-5z",      x, y, 100, cbBorder, cbFill);
-  if (sd & 0b0000000001000000) gfxDraw::pathByText("M11 50h18l4 4v1l-4 4h-18l-4 -4v-1z",  x, y, 100, cbBorder, cbFill);
-  if (sd & 0b0000000010000000) gfxDraw::pathByText("M58 50h-18l-4 4v1l4 4h18l4 -4v-1z",   x, y, 100, cbBorder, cbFill);
-  if (sd & 0b0000000100000000) gfxDraw::pathByText("M1, 99v-42l4, 0l5, 5v36l-5, 5z",      x, y, 100, cbBorder, cbFill);
-  if (sd & 0b0000001000000000) gfxDraw::pathByText("M13, 97h4 l10, -20v-15h-3l-11, 23z",  x, y, 100, cbBorder, cbFill);
-  if (sd & 0b0000010000000000) gfxDraw::pathByText("M30, 97h9v-34l-4, -4h-1l-4, 4",       x, y, 100, cbBorder, cbFill);
-  if (sd & 0b0000100000000000) gfxDraw::pathByText("M56, 97h-4l-10, -20v-15h3l11, 23z",   x, y, 100, cbBorder, cbFill);
-  if (sd & 0b0001000000000000) gfxDraw::pathByText("M68, 99v-42l-4, 0l-5, 5v36l5, 5z",    x, y, 100, cbBorder, cbFill);
-  if (sd & 0b0010000000000000) gfxDraw::pathByText("M10, 108h49l3, -3l-5, -5h-45l-5, 5z", x, y, 100, cbBorder, cbFill);
+  static constexpr auto S0  = GFXDRAW_PATH("M 10 1h49l3 3l-5 5h-45l-5 -5Z");
+  static constexpr auto S1  = GFXDRAW_PATH("M1 10v42h4l5 -5v-36l-5 -5Z");
+  static constexpr auto S2  = GFXDRAW_PATH("M13 12h4l10 20v15h-3l-11 -23z");
+  static constexpr auto S3  = GFXDRAW_PATH("M30 12h9v34l-4 4h-1l-4 -4z");
+  static constexpr auto S4  = GFXDRAW_PATH("M56 12h-4l-10 20v15h3l11 -23z");
+  static constexpr auto S5  = GFXDRAW_PATH("M68 10v42l-4 0l-5 -5v-36 l5-5z");
+  static constexpr auto S6  = GFXDRAW_PATH("M11 50h18l4 4v1l-4 4h-18l-4 -4v-1z");
+  static constexpr auto S7  = GFXDRAW_PATH("M58 50h-18l-4 4v1l4 4h18l4 -4v-1z");
+  static constexpr auto S8  = GFXDRAW_PATH("M1, 99v-42l4, 0l5, 5v36l-5, 5z");
+  static constexpr auto S9  = GFXDRAW_PATH("M13, 97h4 l10, -20v-15h-3l-11, 23z");
+  static constexpr auto S10 = GFXDRAW_PATH("M30, 97h9v-34l-4, -4h-1l-4, 4");
+  static constexpr auto S11 = GFXDRAW_PATH("M56, 97h-4l-10, -20v-15h3l11, 23z");
+  static constexpr auto S12 = GFXDRAW_PATH("M68, 99v-42l-4, 0l-5, 5v36l5, 5z");
+  static constexpr auto S13 = GFXDRAW_PATH("M10, 108h49l3, -3l-5, -5h-45l-5, 5z");
   // clang-format on
+
+  if (sd & 0b0000000000000001) drawDigitSegment(S0, x, y, cbBorder, cbFill);
+  if (sd & 0b0000000000000010) drawDigitSegment(S1, x, y, cbBorder, cbFill);
+  if (sd & 0b0000000000000100) drawDigitSegment(S2, x, y, cbBorder, cbFill);
+  if (sd & 0b0000000000001000) drawDigitSegment(S3, x, y, cbBorder, cbFill);
+  if (sd & 0b0000000000010000) drawDigitSegment(S4, x, y, cbBorder, cbFill);
+  if (sd & 0b0000000000100000) drawDigitSegment(S5, x, y, cbBorder, cbFill);
+  if (sd & 0b0000000001000000) drawDigitSegment(S6, x, y, cbBorder, cbFill);
+  if (sd & 0b0000000010000000) drawDigitSegment(S7, x, y, cbBorder, cbFill);
+  if (sd & 0b0000000100000000) drawDigitSegment(S8, x, y, cbBorder, cbFill);
+  if (sd & 0b0000001000000000) drawDigitSegment(S9, x, y, cbBorder, cbFill);
+  if (sd & 0b0000010000000000) drawDigitSegment(S10, x, y, cbBorder, cbFill);
+  if (sd & 0b0000100000000000) drawDigitSegment(S11, x, y, cbBorder, cbFill);
+  if (sd & 0b0001000000000000) drawDigitSegment(S12, x, y, cbBorder, cbFill);
+  if (sd & 0b0010000000000000) drawDigitSegment(S13, x, y, cbBorder, cbFill);
 }
 
 
@@ -22,10 +22,13 @@
 
 #ifdef ARDUINO
 #include <Arduino.h>
+#else
+#include <stdio.h>
 #endif
 
 #include <functional>
 #include <vector>
+#include <array>
 #include <algorithm>
 
 #include <cctype>
@@ -37,6 +40,9 @@
 // Alpha+RGB Color implementation
 #include "gfxDrawColors.h"
 
+// Alpha compositing
+#include "gfxDrawBlend.h"
+
 // Points, Trigonometric functions
 #include "gfxDrawCommon.h"
 
@@ -16,68 +16,80 @@
 #endif
 
 
-#define SCALEFACTOR 1024
-#define SCALESHIFT 10
-#define SCALEUP(v) (v << SCALESHIFT)
-#define SCALEDOWN(v) ((v + SCALEFACTOR / 2) >> SCALESHIFT)
-
 namespace gfxDraw {
 
 // This implementation of cubic bezier curve with a start and an end point given and by using 2 control points.
 // C x1 y1, x2 y2, x y
 
+// The polynomial form of the curve is v(t) = a*t^3 + b*t^2 + c*t + v0 with
+// a = v3 - 3*v2 + 3*v1 - v0, b = 3*(v2 - 2*v1 + v0) and c = 3*(v1 - v0).
+// With the step width h = 1 / steps the differences of the values are
+// d1 = a*h^3 + b*h^2 + c*h, d2 = 6*a*h^3 + 2*b*h^2 and d3 = 6*a*h^3.
+
+
+/// @brief rounded division of a signed value.
+static int64_t _roundDiv(int64_t v, int64_t d) {
+  return ((v < 0) ? -((-v + d / 2) / d) : ((v + d / 2) / d));
+}  // _roundDiv()
+
+
+int32_t _bezierSteps(const _BezierPoints &b) {
+  int64_t maxDelta = 0;
+  for (int16_t n = 0; n < 3; n++) {
+    int64_t dx = b.x[n + 1] - b.x[n];
+    int64_t dy = b.y[n + 1] - b.y[n];
+    if (dx < 0) dx = -dx;
+    if (dy < 0) dy = -dy;
+    if (dx > maxDelta) maxDelta = dx;
+    if (dy > maxDelta) maxDelta = dy;
+  }
+  int64_t steps = (3 * maxDelta + 65535) >> 16;
+  if (steps < 1) steps = 1;
+  if (steps > INT32_MAX) steps = INT32_MAX;
+  return ((int32_t)steps);
+}  // _bezierSteps()
+
+
+void _bezierSplit(const _BezierPoints &b, _BezierPoints &left, _BezierPoints &right) {
+  auto split = [](const int64_t v[4], int64_t l[4], int64_t r[4]) {
+    int64_t v01 = (v[0] + v[1]) >> 1;
+    int64_t v12 = (v[1] + v[2]) >> 1;
+    int64_t v23 = (v[2] + v[3]) >> 1;
+    int64_t v012 = (v01 + v12) >> 1;
+    int64_t v123 = (v12 + v23) >> 1;
+    int64_t v0123 = (v012 + v123) >> 1;
+
+    r[3] = v[3];
+    r[2] = v23;
+    r[1] = v123;
+    r[0] = v0123;
+    l[3] = v0123;
+    l[2] = v012;
+    l[1] = v01;
+    l[0] = v[0];
+  };
+  split(b.x, left.x, right.x);
+  split(b.y, left.y, right.y);
+}  // _bezierSplit()
+
+
+void _bezierDifferences(const int64_t v[4], int32_t steps, int64_t d[4]) {
+  int64_t a = v[3] - 3 * v[2] + 3 * v[1] - v[0];
+  int64_t b = 3 * (v[2] - 2 * v[1] + v[0]);
+  int64_t c = 3 * (v[1] - v[0]);
+  int64_t n = steps;
+  int64_t n3 = n * n * n;
+
+  d[0] = v[0] * 65536;
+  d[1] = _roundDiv((a + b * n + c * n * n) * 65536, n3);
+  d[2] = _roundDiv((6 * a + 2 * b * n) * 65536, n3);
+  d[3] = _roundDiv((6 * a) * 65536, n3);
+}  // _bezierDifferences()
+
+
 void drawCubicBezier(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, fSetPixel cbDraw) {
-  // GFX_TRACE("cubicBezier: %d/%d %d/%d %d/%d %d/%d", x0, y0, x1, y1, x2, y2, x3, y3);
-
-  // Line 1 is x0/y0 to x1/y1, dx1/dy1 is the relative vector from x0/y0 to x1/y1
-  int16_t dx1 = (x1 - x0);
-  int16_t dy1 = (y1 - y0);
-  int16_t dx2 = (x2 - x1);
-  int16_t dy2 = (y2 - y1);
-  int16_t dx3 = (x3 - x2);
-  int16_t dy3 = (y3 - y2);
-
-  // heuristic: calc the number of steps we need
-  uint16_t steps = (abs(dx1) + abs(dy1) + abs(dx2) + abs(dy2) + abs(dx3) + abs(dy3));  // p0 - 1 - 2 - 3 - 4 - p3
-                                                                                       // GFX_TRACE("steps:%d", steps);
-  proposePixel(x0, y0, cbDraw);
-
-  for (uint16_t n = 1; n <= steps; n++) {
-    int32_t f = (SCALEFACTOR * n) / steps;
-    // 3 points and 3 deltas in 1000 units
-    int32_t x4 = SCALEUP(x0) + (f * dx1);
-    int32_t y4 = SCALEUP(y0) + (f * dy1);
-    int32_t x5 = SCALEUP(x1) + (f * dx2);
-    int32_t y5 = SCALEUP(y1) + (f * dy2);
-    int32_t x6 = SCALEUP(x2) + (f * dx3);
-    int32_t y6 = SCALEUP(y2) + (f * dy3);
-    int32_t dx5 = (x5 - x4);
-    int32_t dy5 = (y5 - y4);
-    int32_t dx6 = (x6 - x5);
-    int32_t dy6 = (y6 - y5);
-
-    // 2 points
-    int32_t x7 = x4 + SCALEDOWN(f * dx5);
-    int32_t y7 = y4 + SCALEDOWN(f * dy5);
-    int32_t x8 = x5 + SCALEDOWN(f * dx6);
-    int32_t y8 = y5 + SCALEDOWN(f * dy6);
-    int32_t dx8 = (x8 - x7);
-    int32_t dy8 = (y8 - y7);
-
-    // 1 point
-    int32_t x9 = x7 + SCALEDOWN(f * dx8);
-    int32_t y9 = y7 + SCALEDOWN(f * dy8);
-
-    int16_t nextX = SCALEDOWN(x9);
-    int16_t nextY = SCALEDOWN(y9);
-
-    proposePixel(nextX, nextY, cbDraw);
-  }  // for
-  proposePixel(x3, y3, cbDraw);
-
-  // flush all Pixels
-  proposePixel(0, POINT_BREAK_Y, cbDraw);
-};  // drawCubicBezier()
+  drawCubicBezier<fSetPixel &>(x0, y0, x1, y1, x2, y2, x3, y3, cbDraw);
+}  // drawCubicBezier()
 
 }  // gfxDraw:: namespace
 
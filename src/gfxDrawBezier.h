@@ -27,10 +27,99 @@ namespace gfxDraw {
 // This implementation of cubic bezier curve with a start and an end point given and by using 2 control points.
 // C x1 y1, x2 y2, x y
 // good article for reading: <https://pomax.github.io/bezierinfo/>
-// Here the Casteljau's algorithm approach is used.
+// Here the curve is split into short pieces using Casteljau's algorithm and the points of every piece are calculated by
+// forward differencing with about one pixel per step.
 
 void drawCubicBezier(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, fSetPixel cbDraw);
 
+/// @brief Control points of a bezier curve (piece) in 1/65536 pixel units.
+struct _BezierPoints {
+  int64_t x[4];
+  int64_t y[4];
+};
+
+/// @brief maximal number of steps of a bezier piece calculated by forward differencing.
+constexpr int32_t BEZIER_MAX_STEPS = 64;
+
+/// @brief Number of steps for a bezier piece so every step moves by at most one pixel in x and y.
+/// The speed of the curve is limited by 3 times the largest difference of the control points.
+/// @return number of steps, more than BEZIER_MAX_STEPS when the piece must be split.
+int32_t _bezierSteps(const _BezierPoints &b);
+
+/// @brief Split a bezier piece at t = 0.5 using Casteljau's algorithm.
+/// @param b piece to be split.
+/// @param left first half of the piece.
+/// @param right second half of the piece.
+void _bezierSplit(const _BezierPoints &b, _BezierPoints &left, _BezierPoints &right);
+
+/// @brief Calculate the points of a bezier piece by forward differencing.
+/// @param v control point values of one coordinate in 1/65536 pixel units.
+/// @param steps number of steps, max. BEZIER_MAX_STEPS.
+/// @param d start value and the first, second and third differences in 1/2^32 pixel units.
+void _bezierDifferences(const int64_t v[4], int32_t steps, int64_t d[4]);
+
+
+/// @brief Draw a cubic bezier curve with any callable as pixel callback using the given PixelStreamFilter.
+/// Pixels still buffered from the previous segment of a path are filtered together with the start of the curve.
+/// The filter is flushed at the end of the curve, so the end point is always drawn.
+template<typename TSetPixel>
+void drawCubicBezier(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, TSetPixel &&cbDraw, PixelStreamFilter &filter) {
+  // GFX_TRACE("cubicBezier: %d/%d %d/%d %d/%d %d/%d", x0, y0, x1, y1, x2, y2, x3, y3);
+
+  // Pieces that are waiting to be drawn, the next piece on top.
+  // Every split halves the control point differences so 16 levels are enough for 16 bit coordinates.
+  _BezierPoints stack[16];
+  int16_t top = 0;
+
+  stack[0] = { { (int64_t)x0 << 16, (int64_t)x1 << 16, (int64_t)x2 << 16, (int64_t)x3 << 16 },
+               { (int64_t)y0 << 16, (int64_t)y1 << 16, (int64_t)y2 << 16, (int64_t)y3 << 16 } };
+
+  filter.propose(x0, y0, cbDraw);
+
+  while (top >= 0) {
+    _BezierPoints &b = stack[top];
+    int32_t steps = _bezierSteps(b);
+
+    if ((steps > BEZIER_MAX_STEPS) && (top < 15)) {
+      // split into 2 pieces, the first half on top.
+      _BezierPoints left;
+      _bezierSplit(b, left, stack[top + 1]);
+      stack[top] = stack[top + 1];
+      stack[top + 1] = left;
+      top++;
+
+    } else {
+      int64_t dx[4], dy[4];
+      _bezierDifferences(b.x, steps, dx);
+      _bezierDifferences(b.y, steps, dy);
+
+      for (int32_t n = 1; n <= steps; n++) {
+        dx[0] += dx[1];
+        dx[1] += dx[2];
+        dx[2] += dx[3];
+        dy[0] += dy[1];
+        dy[1] += dy[2];
+        dy[2] += dy[3];
+        filter.propose((int16_t)((dx[0] + ((int64_t)1 << 31)) >> 32), (int16_t)((dy[0] + ((int64_t)1 << 31)) >> 32), cbDraw);
+      }  // for
+      top--;
+    }
+  }
+  filter.propose(x3, y3, cbDraw);
+
+  // flush all Pixels
+  filter.flush(cbDraw);
+}  // drawCubicBezier()
+
+
+/// @brief Draw a cubic bezier curve with any callable as pixel callback.
+/// The pixels are passed through a local PixelStreamFilter so the function is re-entrant.
+template<typename TSetPixel>
+void drawCubicBezier(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, TSetPixel &&cbDraw) {
+  PixelStreamFilter filter;
+  drawCubicBezier(x0, y0, x1, y1, x2, y2, x3, y3, cbDraw, filter);
+}  // drawCubicBezier()
+
 }  // gfxDraw:: namespace
 
 
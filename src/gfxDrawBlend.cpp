@@ -0,0 +1,212 @@
+// - - - - -
+// GFXDraw - A Arduino library for drawing shapes on a GFX display using paths describing the borders.
+// gfxDrawBlend.cpp: Library implementation file for alpha compositing of colors with premultiplied alpha.
+//
+// Copyright (c) 2024-2024 by Matthias Hertel, http://www.mathertel.de
+// This work is licensed under a BSD style license. See http://www.mathertel.de/License.aspx
+//
+// Changelog: See gfxDrawBlend.h and documentation files in this library.
+//
+// - - - - -
+
+#include "gfxDraw.h"
+
+#ifndef GFX_TRACE
+#define GFX_TRACE(...)  // GFXDRAWTRACE(__VA_ARGS__)
+#endif
+
+// The SIMD kernels are used on x86 hosts with SSE2.  AVX2 is detected at runtime with gcc and clang and used at compile
+// time with other compilers when enabled by the compiler options.
+#if !defined(GFXDRAW_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)))
+#define GFXDRAW_BLEND_SSE2
+#include <immintrin.h>
+
+#if defined(__GNUC__)
+#define GFXDRAW_BLEND_AVX2 __attribute__((target("avx2")))
+#elif defined(__AVX2__)
+#define GFXDRAW_BLEND_AVX2
+#endif
+#endif
+
+
+namespace gfxDraw {
+
+// ===== portable implementation =====
+
+void _blendRowScalar(PARGB *dst, const PARGB *src, int16_t len) {
+  for (int16_t n = 0; n < len; n++) {
+    dst[n] = blendPixel(dst[n], src[n]);
+  }
+}  // _blendRowScalar()
+
+
+static void _blendColorScalar(PARGB *dst, PARGB color, int16_t len) {
+  if (color.Alpha == 255) {
+    std::fill(dst, dst + len, color);
+  } else {
+    for (int16_t n = 0; n < len; n++) {
+      dst[n] = blendPixel(dst[n], color);
+    }
+  }
+}  // _blendColorScalar()
+
+
+#ifdef GFXDRAW_BLEND_SSE2
+
+// ===== SSE2 implementation, 4 pixels per step =====
+
+// blend 4 source pixels over 4 destination pixels.
+static inline __m128i _blend4(__m128i d, __m128i s) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i c255 = _mm_set1_epi16(255);
+  const __m128i c128 = _mm_set1_epi16(128);
+
+  // 255 - alpha of every pixel in the 4 16-bit lanes of the pixel.
+  __m128i a = _mm_srli_epi32(s, 24);
+  a = _mm_or_si128(a, _mm_slli_epi32(a, 16));
+  __m128i ia = _mm_sub_epi16(c255, a);
+  __m128i iaLo = _mm_unpacklo_epi32(ia, ia);
+  __m128i iaHi = _mm_unpackhi_epi32(ia, ia);
+
+  // multiply the destination components and divide by 255 with rounding.
+  __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), iaLo), c128);
+  __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), iaHi), c128);
+  lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+  hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+
+  return (_mm_add_epi8(s, _mm_packus_epi16(lo, hi)));
+}  // _blend4()
+
+
+static void _blendRowSSE2(PARGB *dst, const PARGB *src, int16_t len) {
+  int16_t n = 0;
+  for (; n + 4 <= len; n += 4) {
+    __m128i d = _mm_loadu_si128((const __m128i *)(dst + n));
+    __m128i s = _mm_loadu_si128((const __m128i *)(src + n));
+    _mm_storeu_si128((__m128i *)(dst + n), _blend4(d, s));
+  }
+  _blendRowScalar(dst + n, src + n, len - n);
+}  // _blendRowSSE2()
+
+
+static void _blendColorSSE2(PARGB *dst, PARGB color, int16_t len) {
+  const __m128i s = _mm_set1_epi32(color.raw);
+  int16_t n = 0;
+  for (; n + 4 <= len; n += 4) {
+    __m128i d = _mm_loadu_si128((const __m128i *)(dst + n));
+    _mm_storeu_si128((__m128i *)(dst + n), _blend4(d, s));
+  }
+  _blendColorScalar(dst + n, color, len - n);
+}  // _blendColorSSE2()
+
+#endif
+
+
+#ifdef GFXDRAW_BLEND_AVX2
+
+// ===== AVX2 implementation, 8 pixels per step =====
+
+// blend 8 source pixels over 8 destination pixels, the same steps as _blend4 in both 128-bit halves.
+GFXDRAW_BLEND_AVX2 static inline __m256i _blend8(__m256i d, __m256i s) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i c255 = _mm256_set1_epi16(255);
+  const __m256i c128 = _mm256_set1_epi16(128);
+
+  __m256i a = _mm256_srli_epi32(s, 24);
+  a = _mm256_or_si256(a, _mm256_slli_epi32(a, 16));
+  __m256i ia = _mm256_sub_epi16(c255, a);
+  __m256i iaLo = _mm256_unpacklo_epi32(ia, ia);
+  __m256i iaHi = _mm256_unpackhi_epi32(ia, ia);
+
+  __m256i lo = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), iaLo), c128);
+  __m256i hi = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), iaHi), c128);
+  lo = _mm256_srli_epi16(_mm256_add_epi16(lo, _mm256_srli_epi16(lo, 8)), 8);
+  hi = _mm256_srli_epi16(_mm256_add_epi16(hi, _mm256_srli_epi16(hi, 8)), 8);
+
+  return (_mm256_add_epi8(s, _mm256_packus_epi16(lo, hi)));
+}  // _blend8()
+
+
+GFXDRAW_BLEND_AVX2 static void _blendRowAVX2(PARGB *dst, const PARGB *src, int16_t len) {
+  int16_t n = 0;
+  for (; n + 8 <= len; n += 8) {
+    __m256i d = _mm256_loadu_si256((const __m256i *)(dst + n));
+    __m256i s = _mm256_loadu_si256((const __m256i *)(src + n));
+    _mm256_storeu_si256((__m256i *)(dst + n), _blend8(d, s));
+  }
+  _blendRowSSE2(dst + n, src + n, len - n);
+}  // _blendRowAVX2()
+
+
+GFXDRAW_BLEND_AVX2 static void _blendColorAVX2(PARGB *dst, PARGB color, int16_t len) {
+  const __m256i s = _mm256_set1_epi32(color.raw);
+  int16_t n = 0;
+  for (; n + 8 <= len; n += 8) {
+    __m256i d = _mm256_loadu_si256((const __m256i *)(dst + n));
+    _mm256_storeu_si256((__m256i *)(dst + n), _blend8(d, s));
+  }
+  _blendColorSSE2(dst + n, color, len - n);
+}  // _blendColorAVX2()
+
+
+// check the processor once.
+static bool _hasAVX2() {
+#if defined(__GNUC__)
+  static const bool avx2 = __builtin_cpu_supports("avx2");
+  return (avx2);
+#else
+  return (true);
+#endif
+}  // _hasAVX2()
+
+#endif
+
+
+// ===== blend functions =====
+
+void blendRow(PARGB *dst, const PARGB *src, int16_t len) {
+#if defined(GFXDRAW_BLEND_AVX2)
+  if (_hasAVX2()) {
+    _blendRowAVX2(dst, src, len);
+    return;
+  }
+#endif
+#if defined(GFXDRAW_BLEND_SSE2)
+  _blendRowSSE2(dst, src, len);
+#else
+  _blendRowScalar(dst, src, len);
+#endif
+}  // blendRow()
+
+
+void blendRow(PARGB *dst, PARGB color, int16_t len) {
+  if (color.raw == 0) return;  // fully transparent
+
+#if defined(GFXDRAW_BLEND_AVX2)
+  if (_hasAVX2()) {
+    _blendColorAVX2(dst, color, len);
+    return;
+  }
+#endif
+#if defined(GFXDRAW_BLEND_SSE2)
+  _blendColorSSE2(dst, color, len);
+#else
+  _blendColorScalar(dst, color, len);
+#endif
+}  // blendRow()
+
+
+const char *blendKernel() {
+#if defined(GFXDRAW_BLEND_AVX2)
+  if (_hasAVX2()) return ("AVX2");
+#endif
+#if defined(GFXDRAW_BLEND_SSE2)
+  return ("SSE2");
+#else
+  return ("scalar");
+#endif
+}  // blendKernel()
+
+}  // namespace gfxDraw
+
+// End.
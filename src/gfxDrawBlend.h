@@ -0,0 +1,63 @@
+// - - - - -
+// GFXDraw - A Arduino library for drawing shapes on a GFX display using paths describing the borders.
+// gfxDrawBlend.h: Alpha compositing of colors with premultiplied alpha.
+//
+// Copyright (c) 2024-2024 by Matthias Hertel, http://www.mathertel.de
+// This work is licensed under a BSD style license. See http://www.mathertel.de/License.aspx
+//
+// The blend functions combine a source color over a destination pixel (source-over) using premultiplied colors:
+//   dst = src + dst * (255 - src.Alpha) / 255
+// The row functions use SSE2 or AVX2 instructions on x86 hosts, all implementations calculate the same values.
+// Define GFXDRAW_NO_SIMD to use the portable implementation only.
+//
+// Changelog: See gfxDraw.h and documentation files in this library.
+//
+// - - - - -
+
+#pragma once
+
+namespace gfxDraw {
+
+/// @brief Blend a premultiplied color over a premultiplied pixel.
+/// @param dst the current pixel, e.g. from a framebuffer.
+/// @param src the color drawn over the pixel.
+/// @return the new pixel.
+inline PARGB blendPixel(PARGB dst, PARGB src) {
+  uint32_t ia = 255 - src.Alpha;
+  if (ia == 0) return (src);
+
+  // 2 components in one multiplication, the division by 255 is rounded.
+  uint32_t rb = (dst.raw & 0x00FF00FF) * ia + 0x00800080;
+  rb = ((rb + ((rb >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+  uint32_t ag = ((dst.raw >> 8) & 0x00FF00FF) * ia + 0x00800080;
+  ag = (ag + ((ag >> 8) & 0x00FF00FF)) & 0xFF00FF00;
+
+  PARGB result;
+  result.raw = src.raw + (rb | ag);
+  return (result);
+}  // blendPixel()
+
+
+/// @brief Blend a row of premultiplied pixels over the destination pixels.
+/// This can be used in a fDrawRow callback or with the rows of a SpritePARGB.
+/// @param dst the destination pixels, e.g. a row in a framebuffer.
+/// @param src the pixels drawn over the destination.
+/// @param len number of pixels.
+void blendRow(PARGB *dst, const PARGB *src, int16_t len);
+
+/// @brief Blend a premultiplied color over the destination pixels.
+/// This can be used in a fDrawSpan callback for translucent fills and overlays.
+/// @param dst the destination pixels, e.g. a row in a framebuffer.
+/// @param color the color drawn over the destination.
+/// @param len number of pixels.
+void blendRow(PARGB *dst, PARGB color, int16_t len);
+
+/// @brief The name of the blend implementation used by blendRow on this processor: "scalar", "SSE2" or "AVX2".
+const char *blendKernel();
+
+/// @brief The portable implementation of blendRow.
+void _blendRowScalar(PARGB *dst, const PARGB *src, int16_t len);
+
+}  // namespace gfxDraw
+
+// End.
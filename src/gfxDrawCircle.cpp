@@ -25,46 +25,221 @@ namespace gfxDraw {
 
 // from: http://members.chello.at/easyfilter/bresenham.html
 
+
+// ===== circle segments by octants =====
+
+// The pixels of the quadrant 0 from drawCircleQuadrant are symmetric to the diagonal. In the first octant (x > y)
+// there is exactly one pixel for every y with x = f(y) = the smallest x with (2x+1)^2 + 4y^2 > 4r^2.
+// The second octant has the mirrored pixels with exactly one pixel for every x.
+// The pixel on the diagonal with f(d) = d is drawn unless the pixel before also has x = d (no corner pixels).
+// This allows calculating the first and last pixel of a segment directly instead of comparing every pixel.
+
+// x of the pixel in the first octant for a given y.
+int32_t _circleX(int32_t radius, int32_t y) {
+  return ((int32_t)((isqrt(4 * ((uint64_t)radius * radius - (uint64_t)y * y)) + 1) / 2));
+}  // _circleX()
+
+
+// largest y in the first octant with a pixel x > b or -1 if there is none.
+static int32_t _circleMaxY(int32_t radius, int32_t b) {
+  if (b < 0) return (radius);
+  int64_t m = 4 * (int64_t)radius * radius - (int64_t)(2 * b + 1) * (2 * b + 1);
+  if (m < 0) return (-1);
+  return ((int32_t)(isqrt((uint64_t)m) / 2));
+}  // _circleMaxY()
+
+
+#if GFXDRAW_CIRCLE_CACHE > 0
+
+// The cache keeps the x values of the first octant for the last used radius values.
+struct _CircleCacheEntry {
+  int16_t radius = -1;
+  int16_t last = 0;
+  bool diagonal = false;
+  uint16_t users = 0;
+  uint32_t lastUse = 0;
+  int16_t x[GFXDRAW_CIRCLE_CACHE_RADIUS * 3 / 4 + 2];
+};
+
+#ifdef GFXDRAW_THREADS
+static thread_local _CircleCacheEntry _circleCache[GFXDRAW_CIRCLE_CACHE];
+static thread_local uint32_t _circleCacheClock = 0;
+#else
+static _CircleCacheEntry _circleCache[GFXDRAW_CIRCLE_CACHE];
+static uint32_t _circleCacheClock = 0;
+#endif
+
+#endif
+
+
+// Get the first octant from the cache or calculate it.
+// Entries in use are not replaced so circles can also be drawn from the callback of another circle.
+_CircleOctant::_CircleOctant(int16_t r) {
+  radius = r;
+
+#if GFXDRAW_CIRCLE_CACHE > 0
+  if ((r > 0) && (r <= GFXDRAW_CIRCLE_CACHE_RADIUS)) {
+    _CircleCacheEntry *free = nullptr;
+    for (_CircleCacheEntry &e : _circleCache) {
+      if (e.radius == r) {
+        _entry = &e;
+        break;
+      } else if ((e.users == 0) && ((!free) || (e.lastUse < free->lastUse))) {
+        free = &e;
+      }
+    }
+
+    if ((!_entry) && (free)) {
+      // replace the least recently used entry
+      _entry = free;
+      _entry->radius = r;
+      _calcOctant();
+      _entry->last = last;
+      _entry->diagonal = diagonal;
+
+      int16_t y = 0;
+      _forOctant(0, [&](int16_t x) {
+        _entry->x[y++] = x;
+        return (true);
+      });
+    }
+
+    if (_entry) {
+      _entry->users++;
+      _entry->lastUse = ++_circleCacheClock;
+      last = _entry->last;
+      diagonal = _entry->diagonal;
+      x = _entry->x;
+      return;
+    }
+  }
+#endif
+  _calcOctant();
+}  // _CircleOctant()
+
+
+_CircleOctant::~_CircleOctant() {
+#if GFXDRAW_CIRCLE_CACHE > 0
+  if (_entry) _entry->users--;
+#endif
+}  // ~_CircleOctant()
+
+
+// Calculate the end of the first octant.
+void _CircleOctant::_calcOctant() {
+  int32_t d = isqrt((uint64_t)radius * radius / 2);
+  while ((d < radius) && (_circleX(radius, d + 1) > d + 1)) d++;
+  while ((d >= 0) && (_circleX(radius, d) <= d)) d--;
+  last = d;
+  diagonal = ((_circleX(radius, d + 1) == d + 1) && ((d < 0) || (_circleX(radius, d) != d + 1)));
+}  // _calcOctant()
+
+
 /// @brief Draw the circle quadrant with the pixels in the given order.
 /// @param radius radius of the circle
 /// @param q number of quadrant (see header file)
 /// @param cbDraw will be called for all pixels in the Circle Quadrant
 void drawCircleQuadrant(int16_t radius, int16_t q, fSetPixel cbDraw) {
   GFX_TRACE("drawCircleQuadrant(r=%d)", radius);
+  _CircleOctant oct(radius);
+  _drawCircleQuadrant(oct, q, cbDraw);
+}  // drawCircleQuadrant()
 
-  int16_t x = -radius, y = 0;
-  int16_t err = 2 - 2 * radius; /* II. Quadrant */
 
-  do {
+// Draw the pixels of the quadrant q in clockwise order that are after the startPoint and not after the endPoint.
+// startPoint and endPoint are relative to the center and can be nullptr for drawing from the begin or to the end of
+// the quadrant. Points are "after" another point as defined by Point::compareCircle.
+// The pixel on the axis at the end of the quadrant belongs to the next quadrant.
+static void _drawCircleQuadrantSegment(Point center, const _CircleOctant &oct, int16_t q,
+                                       const Point *startPoint, const Point *endPoint, fSetPixel &cbDraw) {
+  int16_t radius = oct.radius;
+
+  // rotate points into quadrant 0 and the pixels back to quadrant q.
+  auto toQ0 = [&](Point p) {
+    if (q == 1) return (Point(p.y, -p.x));
+    if (q == 2) return (Point(-p.x, -p.y));
+    if (q == 3) return (Point(-p.y, p.x));
+    return (p);
+  };
+  auto draw = [&](int16_t x, int16_t y) {
     if (q == 0) {
-      cbDraw(-x, y);
+      cbDraw(center.x + x, center.y + y);
     } else if (q == 1) {
-      cbDraw(-y, -x);
+      cbDraw(center.x - y, center.y + x);
     } else if (q == 2) {
-      cbDraw(x, -y);
-    } else if (q == 3) {
-      cbDraw(y, x);
+      cbDraw(center.x - x, center.y - y);
+    } else {
+      cbDraw(center.x + y, center.y - x);
     }
-    radius = err;
-    if (radius <= y) err += ++y * 2 + 1;            // y step and error adjustment
-    if (radius > x || err > y) err += ++x * 2 + 1;  // x step and error adjustment
-  } while (x <= 0);
-}  // drawCircleQuadrant()
+  };
+
+  // the first octant from y = 0 to y = last and the pixel on the diagonal.
+  // A pixel is after p when (y > p.y) or (x < p.x).
+  int32_t yFrom = 0;
+  int32_t yTo = oct.last + (oct.diagonal ? 2 : 1);  // excluding
+  Point s, e;
+
+  if (startPoint) {
+    s = toQ0(*startPoint);
+    int32_t y = _circleMaxY(radius, s.x - 1) + 1;
+    yFrom = (s.y + 1 < y) ? s.y + 1 : y;
+    if (yFrom < 0) yFrom = 0;
+  }
+  if (endPoint) {
+    e = toQ0(*endPoint);
+    int32_t y = _circleMaxY(radius, e.x - 1) + 1;
+    if (e.y + 1 < y) y = e.y + 1;
+    if (y < yTo) yTo = y;
+  }
+
+  if (yFrom < yTo) {
+    int16_t y = yFrom;
+    oct.forOctant(yFrom, [&](int16_t x) {
+      draw(x, y++);
+      return (y < yTo);
+    });
+  }
+
+  // the second octant with the mirrored pixels of the first octant with x > y and descending x down to x = 1.
+  // A pixel is after p when (x < p.x) or (y > p.y).
+  int32_t xFrom = oct.last;
+  int32_t xTo = 0;  // excluding
+
+  if (startPoint) {
+    int32_t x = _circleMaxY(radius, s.y);
+    if (s.x - 1 > x) x = s.x - 1;
+    if (x < xFrom) xFrom = x;
+  }
+  if (endPoint) {
+    int32_t x = _circleMaxY(radius, e.y);
+    if (e.x - 1 > x) x = e.x - 1;
+    if (x > xTo) xTo = x;
+  }
+
+  if (xFrom > xTo) {
+    int16_t x = xFrom;
+    oct.forMirrored(xFrom, [&](int16_t y) {
+      draw(x--, y);
+      return (x > xTo);
+    });
+  }
+}  // _drawCircleQuadrantSegment()
 
 
 /// @brief draw a circle segment
 void drawCircleSegment(Point center, int16_t radius, Point startPoint, Point endPoint, ArcFlags flags, fSetPixel cbDraw) {
   GFX_TRACE("drawCircleSegment(%d/%d r=%d)  (%d/%d) -> (%d/%d)", center.x, center.y, radius, startPoint.x, startPoint.y, endPoint.x, endPoint.y);
 
-  int16_t xm = center.x;
-  int16_t ym = center.y;
+  if (radius <= 0) {
+    cbDraw(center.x, center.y);
+    return;
+  }
 
   if ((startPoint == endPoint) && (flags & ArcFlags::LongPath)) {
     // draw a full circle
+    _CircleOctant oct(radius);
     for (int16_t q = 0; q < 4; q++)
-      drawCircleQuadrant(radius, q, [&](int16_t x, int16_t y) {
-        cbDraw(xm + x, ym + y);
-      });
+      _drawCircleQuadrantSegment(center, oct, q, nullptr, nullptr, cbDraw);
     return;
   }
 
@@ -86,6 +261,7 @@ void drawCircleSegment(Point center, int16_t radius, Point startPoint, Point end
   // Clockwise processing only from here.
 
   // Draw from startPoint to endPoint using Quadrants
+  _CircleOctant oct(radius);
   startPoint = startPoint - center;
   endPoint = endPoint - center;
 
@@ -101,65 +277,165 @@ void drawCircleSegment(Point center, int16_t radius, Point startPoint, Point end
     eQ += 4;
   }
 
-  // s=1: before the start
-  // s=2: draw pixels
-  // s=3: after the end
-  uint16_t s = 1;
-
   for (uint16_t q = sQ; q <= eQ; q++) {
-    drawCircleQuadrant(radius, q % 4, [&](int16_t x, int16_t y) {
-      if (s == 1) {
-        if (Point::compareCircle(startPoint, Point(x, y))) {
-          // start drawing the points
-          s = 2;
-        }
-
-      } else if (s == 2) {
-        if (q != eQ) {
-          // draw
-
-        } else if (q == eQ) {
-          if (Point::compareCircle(endPoint, Point(x, y))) {
-            // stop drawing the points
-            s = 3;
-          }
-        }
-      }
-
-      if (s == 2) {
-        cbDraw(xm + x, ym + y);
-      }
-    });
+    _drawCircleQuadrantSegment(center, oct, q % 4,
+                               (q == sQ) ? &startPoint : nullptr,
+                               (q == eQ) ? &endPoint : nullptr,
+                               cbDraw);
   }  // for()
-  // } while (q <= eQ);
-
 };  // drawCircleSegment()
 
 
+// Draw an ellipse segment using a midpoint algorithm that works for rotated ellipses.
+// The points are transformed into normalized coordinates p, q where the ellipse is the unit circle:
+// p = (cos(phi) * u + sin(phi) * v) / rx and q = (-sin(phi) * u + cos(phi) * v) / ry
+// with u, v relative to the center. F = p*p + q*q - 1 is negative inside and positive outside of the ellipse.
+// In every step the tangent direction is calculated from the gradient of F and the next pixel is chosen from the axial
+// and the diagonal neighbor in this direction by the sign of F at the midpoint of both.
+void drawEllipseSegment(int32_t cx256, int32_t cy256, int16_t rx, int16_t ry, int16_t phi,
+                        Point startPoint, Point endPoint, ArcFlags flags, fSetPixel cbDraw) {
+  if ((rx == 0) || (ry == 0)) return;
+
+  int32_t sinphi, cosphi;
+  sinCos65536(DEGREE65536(phi), sinphi, cosphi);
+
+  // coefficients of the transformation in 1/2^32 units.
+  const int64_t k11 = ((int64_t)cosphi << 16) / rx;
+  const int64_t k12 = ((int64_t)sinphi << 16) / rx;
+  const int64_t k21 = (-(int64_t)sinphi << 16) / ry;
+  const int64_t k22 = ((int64_t)cosphi << 16) / ry;
+
+  // normalized coordinates in 1/2^24 units from coordinates relative to the center in 1/256 pixel units.
+  auto pOf = [&](int64_t u, int64_t v) {
+    return ((k11 * u + k12 * v) >> 16);
+  };
+  auto qOf = [&](int64_t u, int64_t v) {
+    return ((k21 * u + k22 * v) >> 16);
+  };
+  auto fOf = [&](int64_t u, int64_t v) {
+    int64_t p = pOf(u, v);
+    int64_t q = qOf(u, v);
+    return ((p * p) + (q * q) - ((int64_t)1 << 48));
+  };
+
+  // +1 for increasing angles (clockwise on the display), -1 for decreasing angles.
+  const int16_t dir = (flags & ArcFlags::Clockwise) ? 1 : -1;
+
+  // The end is reached when the ray from the center through the end point is crossed.
+  const int64_t pe = pOf(256 * endPoint.x - cx256, 256 * endPoint.y - cy256);
+  const int64_t qe = qOf(256 * endPoint.x - cx256, 256 * endPoint.y - cy256);
+  auto side = [&](int64_t p, int64_t q) {
+    int64_t cross = (pe * q) - (qe * p);
+    return ((dir > 0) ? cross : -cross);
+  };
+
+  int16_t x = startPoint.x;
+  int16_t y = startPoint.y;
+  int64_t u = 256 * x - cx256;
+  int64_t v = 256 * y - cy256;
+  int64_t lastSide = side(pOf(u, v), qOf(u, v));
+
+  // the number of pixels of a whole ellipse is less than 4 * (rx + ry).
+  int32_t maxSteps = 4 * (abs(rx) + abs(ry)) + 8;
+
+  while (maxSteps-- > 0) {
+    int64_t p = pOf(u, v);
+    int64_t q = qOf(u, v);
+
+    // gradient of F and the tangent in drawing direction
+    int64_t gx = (p * k11 + q * k21) >> 16;
+    int64_t gy = (p * k12 + q * k22) >> 16;
+    int64_t tx = -dir * gy;
+    int64_t ty = dir * gx;
+
+    int16_t sx = (tx > 0) ? 1 : ((tx < 0) ? -1 : 0);
+    int16_t sy = (ty > 0) ? 1 : ((ty < 0) ? -1 : 0);
+    bool xMajor = ((tx < 0 ? -tx : tx) >= (ty < 0 ? -ty : ty));
+    bool diagonal;
+
+    if (xMajor) {
+      if (sx == 0) break;
+      if (sy == 0) sy = (gy > 0) ? -1 : 1;  // bend inside
+      int64_t f = fOf(u + 256 * sx, v + 128 * sy);
+      diagonal = ((f == 0) || ((f < 0) != (gy * sy < 0)));
+    } else {
+      if (sx == 0) sx = (gx > 0) ? -1 : 1;  // bend inside
+      int64_t f = fOf(u + 128 * sx, v + 256 * sy);
+      diagonal = ((f == 0) || ((f < 0) != (gx * sx < 0)));
+    }
+
+    int16_t nx = x + ((xMajor || diagonal) ? sx : 0);
+    int16_t ny = y + ((!xMajor || diagonal) ? sy : 0);
+    int64_t nu = 256 * nx - cx256;
+    int64_t nv = 256 * ny - cy256;
+    int64_t np = pOf(nu, nv);
+    int64_t nq = qOf(nu, nv);
+    int64_t nextSide = side(np, nq);
+
+    if ((lastSide < 0) && (nextSide >= 0) && ((pe * np) + (qe * nq) > 0)) {
+      // the end is reached
+      break;
+    }
+
+    x = nx;
+    y = ny;
+    u = nu;
+    v = nv;
+    lastSide = nextSide;
+    cbDraw(x, y);
+  }
+}  // drawEllipseSegment()
+
+
 // Draw a whole circle. The draw function is not called in order of the pixels on the circle.
 void drawCircle(Point center, int16_t radius, fSetPixel cbStroke, fSetPixel cbFill) {
+  if (cbFill) {
+    drawCircle(center, radius, cbStroke, [&](int16_t sx, int16_t ex, int16_t sy) {
+      while (sx <= ex) cbFill(sx++, sy);
+    });
+  } else {
+    drawCircle(center, radius, cbStroke, fDrawSpan(nullptr));
+  }
+}  // drawCircle()
+
+
+// Draw a whole circle with filling spans. The draw function is not called in order of the pixels on the circle.
+void drawCircle(Point center, int16_t radius, fSetPixel cbStroke, fDrawSpan cbFill) {
+  GFXDRAW_STATS_SCOPE(statsScope);
   int16_t xm = center.x;
   int16_t ym = center.y;
   int16_t line = -radius;
 
-  drawCircleQuadrant(radius, 3, [&](int16_t x, int16_t y) {
+  const ClipRect clip = _clipRect;
+  if (!clip.intersects(xm - radius, ym - radius, xm + radius, ym + radius)) return;
+
+  // restrict the pixels and spans to the clip rectangle when the circle is not completely inside.
+  bool clipped = !clip.covers(xm - radius, ym - radius, xm + radius, ym + radius);
+
+  auto stroke = [&](int16_t x, int16_t y) {
+    if ((clipped) && (!clip.contains(x, y))) return;
+    GFXDRAW_STAT(borderPixels, 1);
+    cbStroke(x, y);
+  };
+  auto fill = [&](int16_t x0, int16_t x1, int16_t y) {
+    if ((clipped) && (!clip.clipSpan(x0, x1, y))) return;
+    GFXDRAW_STAT(fillPixels, x1 - x0 + 1);
+    cbFill(x0, x1, y);
+  };
+
+  _CircleOctant oct(radius);
+  _drawCircleQuadrant(oct, 3, [&](int16_t x, int16_t y) {
     // GFX_TRACE(" x=%d y=%d", x, y);
-    cbStroke(xm - x, ym + y);
-    if ((cbFill) && (y != line)) {
-      for (int16_t l = xm - x + 1; l < xm + x; l++) {
-        cbFill(l, ym + y);
-      }
-    }
-    cbStroke(xm + x, ym + y);
+    bool fillLine = ((cbFill) && (y != line) && (x > 0));
+
+    stroke(xm - x, ym + y);
+    if (fillLine) fill(xm - x + 1, xm + x - 1, ym + y);
+    stroke(xm + x, ym + y);
 
     if (y < 0) {
-      cbStroke(xm - x, ym - y);
-      if ((cbFill) && (y != line)) {
-        for (int16_t l = xm - x + 1; l < xm + x; l++) {
-          cbFill(l, ym - y);
-        }
-      }
-      cbStroke(xm + x, ym - y);
+      stroke(xm - x, ym - y);
+      if (fillLine) fill(xm - x + 1, xm + x - 1, ym - y);
+      stroke(xm + x, ym - y);
     }
     line = y;
   });
@@ -173,12 +449,76 @@ void arcCenter(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t &rx, int1
 
   // <https://github.com/canvg/canvg/blob/937668eced93e0335c67a255d0d2277ea708b2cb/src/Document/PathElement.ts#L491>
 
-  double sinphi = sin(phi);
-  double cosphi = cos(phi);
+#ifdef GFXDRAW_NO_FLOAT
+  // The same calculation using fixed-point values scaled by 65536.
+  // The relative coordinates of the middle point a = xTemp / rx and b = yTemp / ry are used
+  // as the radius and center calculation only depends on them.
+  int32_t sinphi, cosphi;
+  sinCos65536(DEGREE65536(phi), sinphi, cosphi);
 
   // middle of (x1/y1) to (x2/y2)
-  double xMiddle = (x1 - x2) / 2;
-  double yMiddle = (y1 - y2) / 2;
+  int32_t xMiddle2 = (x1 - x2);  // 2 * xMiddle
+  int32_t yMiddle2 = (y1 - y2);  // 2 * yMiddle
+
+  int64_t xTemp = (((int64_t)cosphi * xMiddle2) + ((int64_t)sinphi * yMiddle2)) / 2;
+  int64_t yTemp = ((-(int64_t)sinphi * xMiddle2) + ((int64_t)cosphi * yMiddle2)) / 2;
+
+  auto relative = [](int64_t v, int16_t r) {
+    v /= r;
+    if (v > INT32_MAX) v = INT32_MAX;
+    if (v < -INT32_MAX) v = -INT32_MAX;
+    return (v);
+  };
+
+  // adjust x & y radius when too small
+  if (rx == 0 || ry == 0) {
+    int64_t dx = (x1 - x2), dy = (y1 - y2);
+    rx = ry = (int16_t)(isqrt((dx * dx) + (dy * dy)) / 2);
+    GFX_TRACE("rx=ry= %d", rx);
+
+  } else {
+    int64_t a = relative(xTemp, rx);
+    int64_t b = relative(yTemp, ry);
+    uint64_t dist2 = (a * a) + (b * b);
+
+    if (dist2 > ((uint64_t)1 << 32)) {
+      int64_t dist = isqrt(dist2);
+      rx = static_cast<int16_t>((rx * dist + 32768) >> 16);
+      ry = static_cast<int16_t>((ry * dist + 32768) >> 16);
+    }
+    GFX_TRACE("rx=%d ry=%d ", rx, ry);
+  }
+
+  // center calculation: centerDist = sqrt((1 - a*a - b*b) / (a*a + b*b))
+  int64_t cX = 0, cY = 0;
+  if (rx != 0 && ry != 0) {
+    int64_t a = relative(xTemp, rx);
+    int64_t b = relative(yTemp, ry);
+    uint64_t dist2 = (a * a) + (b * b);
+
+    if ((dist2 > 0) && (dist2 < ((uint64_t)1 << 32))) {
+      int64_t sq = isqrt(dist2);
+      int64_t t = isqrt(((uint64_t)1 << 32) - dist2);
+      cX = (rx * b * t) / sq;
+      cY = (-ry * a * t) / sq;
+    }
+  }
+
+  if ((flags == 0x00) || (flags == 0x03)) {
+    cX = -cX;
+    cY = -cY;
+  }
+
+  cx256 = (int32_t)((((cosphi * cX) - (sinphi * cY)) + (1 << 23)) >> 24) + 128 * (x1 + x2);
+  cy256 = (int32_t)((((sinphi * cX) + (cosphi * cY)) + (1 << 23)) >> 24) + 128 * (y1 + y2);
+
+#else
+  double sinphi = sin(phi * M_PI / 180);
+  double cosphi = cos(phi * M_PI / 180);
+
+  // middle of (x1/y1) to (x2/y2)
+  double xMiddle = (x1 - x2) / 2.0;
+  double yMiddle = (y1 - y2) / 2.0;
 
   double xTemp = (cosphi * xMiddle) + (sinphi * yMiddle);
   double yTemp = (-sinphi * xMiddle) + (cosphi * yMiddle);
@@ -202,9 +542,10 @@ void arcCenter(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t &rx, int1
 
   // center calculation
   double centerDist = 0;
-  double distNumerator = ((rx * rx) * (ry * ry) - (rx * rx) * (yTemp * yTemp) - (ry * ry) * (xTemp * xTemp));
-  if (distNumerator > 0) {
-    centerDist = sqrt(distNumerator / ((rx * rx) * (yTemp * yTemp) + (ry * ry) * (xTemp * xTemp)));
+  double distNumerator = (((double)rx * rx) * (ry * ry) - (rx * rx) * (yTemp * yTemp) - (ry * ry) * (xTemp * xTemp));
+  double distDenominator = ((rx * rx) * (yTemp * yTemp) + (ry * ry) * (xTemp * xTemp));
+  if ((distNumerator > 0) && (distDenominator > 0)) {
+    centerDist = sqrt(distNumerator / distDenominator);
   }
 
   if ((flags == 0x00) || (flags == 0x03)) {
@@ -214,20 +555,25 @@ void arcCenter(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t &rx, int1
   double cX = (centerDist * rx * yTemp) / ry;
   double cY = (centerDist * -ry * xTemp) / rx;
 
-  double centerX = (cosphi * cX) - (sinphi * cY) + (x1 + x2) / 2;
-  double centerY = (sinphi * cX) + (cosphi * cY) + (y1 + y2) / 2;
+  double centerX = (cosphi * cX) - (sinphi * cY) + (x1 + x2) / 2.0;
+  double centerY = (sinphi * cX) + (cosphi * cY) + (y1 + y2) / 2.0;
 
   cx256 = std::lround(256 * centerX);
   cy256 = std::lround(256 * centerY);
+#endif
 }  // arcCenter()
 
 
 /// Calculate the angle of a vector in degrees.
 int16_t vectorAngle(int16_t dx, int16_t dy) {
   // GFX_TRACE("vectorAngle(%d, %d)", dx, dy);
+#ifdef GFXDRAW_NO_FLOAT
+  int16_t angle = static_cast<int16_t>((atan2_65536(dy, dx) + 32768) >> 16);
+#else
   double rad = atan2(dy, dx);
   int16_t angle = static_cast<int16_t>(std::lround(rad * 180 / M_PI));
   if (angle < 0) angle = 360 + angle;
+#endif
   return (angle % 360);
 }  // vectorAngle()
 
@@ -245,9 +591,16 @@ int16_t vectorAngle(int16_t dx, int16_t dy) {
 void drawArc(int16_t x1, int16_t y1, int16_t x2, int16_t y2,
              int16_t rx, int16_t ry,
              int16_t phi, int16_t flags,
-             fSetPixel cbDraw) {
+             fSetPixel cbDraw, PixelStreamFilter &filter) {
   GFX_TRACE("drawArc(%d/%d)-(%d/%d)", x1, y1, x2, y2);
 
+  if ((x1 == x2) && (y1 == y2)) {
+    // identical endpoints: the arc is omitted like in SVG.
+    filter.propose(x1, y1, cbDraw);
+    filter.flush(cbDraw);
+    return;
+  }
+
   int32_t cx256, cy256;
 
   arcCenter(x1, y1, x2, y2, rx, ry, phi, flags, cx256, cy256);
@@ -256,7 +609,7 @@ void drawArc(int16_t x1, int16_t y1, int16_t x2, int16_t y2,
   GFX_TRACE("  center = %d/%d", SCALE256(cx256), SCALE256(cy256));
   GFX_TRACE("  radius = %d/%d", rx, ry);
 
-  proposePixel(x1, y1, cbDraw);
+  filter.propose(x1, y1, cbDraw);
   if (rx == ry) {
     // draw a circle segment faster. ellipsis rotation can be ignored.
     gfxDraw::drawCircleSegment(gfxDraw::Point(SCALE256(cx256), SCALE256(cy256)), rx,
@@ -264,24 +617,29 @@ void drawArc(int16_t x1, int16_t y1, int16_t x2, int16_t y2,
                                gfxDraw::Point(x2, y2),
                                (gfxDraw::ArcFlags)(flags & gfxDraw::ArcFlags::Clockwise),
                                [&](int16_t x, int16_t y) {
-                                 proposePixel(x, y, cbDraw);
+                                 filter.propose(x, y, cbDraw);
                                });
   } else {
-    int startAngle = vectorAngle(256 * x1 - cx256, 256 * y1 - cy256);
-    int endAngle = vectorAngle(256 * x2 - cx256, 256 * y2 - cy256);
-    int stepAngle = (flags & 0x02) ? 1 : 359;
-
-    // Iterate through the ellipse
-    for (int16_t angle = startAngle; angle != endAngle; angle = (angle + stepAngle) % 360) {
-      int16_t x = SCALE256(cx256 + (rx * gfxDraw::cos256(angle)));
-      int16_t y = SCALE256(cy256 + (ry * gfxDraw::sin256(angle)));
-      proposePixel(x, y, cbDraw);
-    }
+    gfxDraw::drawEllipseSegment(cx256, cy256, rx, ry, phi,
+                                gfxDraw::Point(x1, y1),
+                                gfxDraw::Point(x2, y2),
+                                (gfxDraw::ArcFlags)(flags & gfxDraw::ArcFlags::Clockwise),
+                                [&](int16_t x, int16_t y) {
+                                  filter.propose(x, y, cbDraw);
+                                });
   }
-  proposePixel(x2, y2, cbDraw);
+  filter.propose(x2, y2, cbDraw);
+  filter.flush(cbDraw);
+
+}  // drawArc()
 
-  proposePixel(0, POINT_BREAK_Y, cbDraw);
 
+void drawArc(int16_t x1, int16_t y1, int16_t x2, int16_t y2,
+             int16_t rx, int16_t ry,
+             int16_t phi, int16_t flags,
+             fSetPixel cbDraw) {
+  PixelStreamFilter filter;
+  drawArc(x1, y1, x2, y2, rx, ry, phi, flags, cbDraw, filter);
 }  // drawArc()
 
 }  // gfxDraw:: namespace
@@ -37,6 +37,21 @@ inline ArcFlags operator|(ArcFlags a, ArcFlags b) {
   return static_cast<ArcFlags>(static_cast<int>(a) | static_cast<int>(b));
 }
 
+/// Number of radius values with cached circle pixel offsets used by drawCircle, drawCircleQuadrant,
+/// drawCircleSegment and drawArc. The least recently used radius is replaced. 0 disables the cache.
+#ifndef GFXDRAW_CIRCLE_CACHE
+#define GFXDRAW_CIRCLE_CACHE 4
+#endif
+
+/// Maximum radius with cached circle pixel offsets. Every cache entry takes about 1.5 * radius bytes.
+#ifndef GFXDRAW_CIRCLE_CACHE_RADIUS
+#if defined(ARDUINO)
+#define GFXDRAW_CIRCLE_CACHE_RADIUS 128
+#else
+#define GFXDRAW_CIRCLE_CACHE_RADIUS 1024
+#endif
+#endif
+
 
 /// ===== Basic draw functions with callback =====
 
@@ -47,6 +62,14 @@ inline ArcFlags operator|(ArcFlags a, ArcFlags b) {
 void drawCircle(Point center, int16_t radius, fSetPixel cbStroke, fSetPixel cbFill = nullptr);
 
 
+/// @brief draw a whole circle with the inner pixels passed as horizontal spans.
+/// @param center center of the circle
+/// @param radius radius of the circle
+/// @param cbStroke SetPixel callback for the border pixels
+/// @param cbFill Span callback for the inner pixels
+void drawCircle(Point center, int16_t radius, fSetPixel cbStroke, fDrawSpan cbFill);
+
+
 /// @brief Calculate all points on the specified quadrant of a circle with center 0/0.
 /// @param radius radius of the circle
 /// @param q number of quadrant (see header file)
@@ -54,7 +77,140 @@ void drawCircle(Point center, int16_t radius, fSetPixel cbStroke, fSetPixel cbFi
 void drawCircleQuadrant(int16_t radius, int16_t q, fSetPixel cbDraw);
 
 
+// ===== internal circle functionality =====
+
+/// @brief x of the pixel in the first octant of a circle for a given y.
+int32_t _circleX(int32_t radius, int32_t y);
+
+struct _CircleCacheEntry;
+
+/// @brief The first octant of a circle with the x values from the cache when available.
+/// Entries in use are not replaced so circles can also be drawn from the callback of another circle.
+class _CircleOctant {
+public:
+  /// @brief Get the first octant of a circle from the cache or calculate it.
+  /// @param r radius of the circle
+  _CircleOctant(int16_t r);
+  ~_CircleOctant();
+
+  /// Pass the x values of the first octant from y = yFrom to the end of the octant.
+  /// The callback returns false to stop.
+  template<typename TCallback>
+  void forOctant(int16_t yFrom, TCallback &&cbX) const {
+    if (x) {
+      for (int16_t y = yFrom; y <= last + (diagonal ? 1 : 0); y++)
+        if (!cbX(x[y])) break;
+    } else {
+      _forOctant(yFrom, cbX);
+    }
+  }
+
+  /// Pass the y values of the mirrored second octant from x = xFrom down to x = 1.
+  /// The callback returns false to stop.
+  template<typename TCallback>
+  void forMirrored(int16_t xFrom, TCallback &&cbY) const {
+    if (x) {
+      for (int16_t mx = xFrom; mx > 0; mx--)
+        if (!cbY(x[mx])) break;
+
+    } else if (xFrom > 0) {
+      int32_t mx = xFrom;
+      int32_t y = _circleX(radius, mx);
+      // err <= 0 when the next pixel has y + 1.
+      int32_t err = (int32_t)((int64_t)(2 * y + 1) * (2 * y + 1) + 4 * (int64_t)(mx - 1) * (mx - 1) - 4 * (int64_t)radius * radius);
+      while (mx > 0) {
+        if (!cbY(y)) break;
+        if (err <= 0) {
+          err += 8 * y + 8;
+          y++;
+        }
+        err += 12 - 8 * mx;
+        mx--;
+      }
+    }
+  }
+
+  int16_t radius;
+  int16_t last;                  ///< last y of the first octant with x > y
+  bool diagonal;                 ///< pixel on the diagonal at y = last + 1
+  const int16_t *x = nullptr;    ///< cached x values of the first octant
+
+private:
+  void _calcOctant();
+
+  template<typename TCallback>
+  void _forOctant(int16_t yFrom, TCallback &&cbX) const {
+    int32_t y = yFrom;
+    int32_t yEnd = last + (diagonal ? 1 : 0);
+    int32_t x = _circleX(radius, y);
+    // err > 0 when the next pixel has x - 1.
+    int32_t err = (int32_t)((int64_t)(2 * x - 1) * (2 * x - 1) + 4 * (int64_t)(y + 1) * (y + 1) - 4 * (int64_t)radius * radius);
+    while (y <= yEnd) {
+      if (!cbX(x)) break;
+      if (err > 0) {
+        err += 8 - 8 * x;
+        x--;
+      }
+      err += 8 * y + 12;
+      y++;
+    }
+  }
+
+#if GFXDRAW_CIRCLE_CACHE > 0
+  _CircleCacheEntry *_entry = nullptr;
+#endif
+};
+
+
+/// @brief Draw all pixels of the quadrant q of a circle with center 0/0.
+template<typename TSetPixel>
+void _drawCircleQuadrant(const _CircleOctant &oct, int16_t q, TSetPixel &&cbDraw) {
+  auto draw = [&](int16_t x, int16_t y) {
+    if (q == 0) {
+      cbDraw(x, y);
+    } else if (q == 1) {
+      cbDraw(-y, x);
+    } else if (q == 2) {
+      cbDraw(-x, -y);
+    } else if (q == 3) {
+      cbDraw(y, -x);
+    }
+  };
+
+  if (oct.radius <= 0) {
+    draw(0, 0);
+    return;
+  }
+
+  int16_t y = 0;
+  oct.forOctant(0, [&](int16_t x) {
+    draw(x, y++);
+    return (true);
+  });
+  int16_t x = oct.last;
+  oct.forMirrored(oct.last, [&](int16_t y) {
+    draw(x--, y);
+    return (true);
+  });
+  draw(0, oct.radius);
+}  // _drawCircleQuadrant()
+
+
+/// @brief Calculate all points on the specified quadrant of a circle with center 0/0 with any callable as pixel callback.
+/// The callback can be inlined by the compiler.
+/// @param radius radius of the circle
+/// @param q number of quadrant (see header file)
+/// @param cbDraw will be called for all pixels in the Circle Quadrant
+template<typename TSetPixel>
+void drawCircleQuadrant(int16_t radius, int16_t q, TSetPixel &&cbDraw) {
+  _CircleOctant oct(radius);
+  _drawCircleQuadrant(oct, q, cbDraw);
+}  // drawCircleQuadrant()
+
+
 /// @brief draw a circle segment or a whole circle.
+/// The pixels after the startPoint and not after the endPoint are drawn, so a segment shorter than one pixel may draw
+/// no pixel. A radius <= 0 draws only the center pixel.
 /// @param center center of the circle
 /// @param radius radius of the circle
 /// @param startPoint first point of the arc
@@ -64,9 +220,28 @@ void drawCircleQuadrant(int16_t radius, int16_t q, fSetPixel cbDraw);
 void drawCircleSegment(Point center, int16_t radius, Point startPoint, Point endPoint, ArcFlags flags, fSetPixel cbDraw);
 
 
+/// @brief draw a segment of a rotated ellipse. The pixels are drawn in order from the start point to the end point.
+/// @param cx256 x coordinate of the center in 1/256 pixel units.
+/// @param cy256 y coordinate of the center in 1/256 pixel units.
+/// @param rx x radius of the ellipse.
+/// @param ry y radius of the ellipse.
+/// @param phi rotation of the ellipse in degrees.
+/// @param startPoint first point of the arc, should be on the ellipse. This point is not drawn.
+/// @param endPoint last point of the arc, should be on the ellipse. This point is not drawn.
+/// @param flags ArcFlags::Clockwise for increasing angles.
+/// @param cbDraw SetPixel callback
+void drawEllipseSegment(int32_t cx256, int32_t cy256, int16_t rx, int16_t ry, int16_t phi,
+                        Point startPoint, Point endPoint, ArcFlags flags, fSetPixel cbDraw);
+
+
 /// @brief Draw an arc using the most efficient algorithm
 void drawArc(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t rx, int16_t ry, int16_t phi, int16_t flags, fSetPixel cbDraw);
 
+/// @brief Draw an arc using the given PixelStreamFilter.
+/// Pixels still buffered from the previous segment of a path are filtered together with the start of the arc.
+/// The filter is flushed at the end of the arc, so the end point is always drawn.
+void drawArc(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t rx, int16_t ry, int16_t phi, int16_t flags, fSetPixel cbDraw, PixelStreamFilter &filter);
+
 
 /// ====== internally used functions - maybe helpful for generating paths
 
@@ -76,6 +251,12 @@ void drawArc(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t rx, int16_t
 /// @return the angle n range 0...359
 int16_t vectorAngle(int16_t dx, int16_t dy);
 
+/// @brief Calculate the center parameterization for an arc from endpoints
+/// The radius values may be scaled up when there is no arc possible.
+/// @param cx256 x coordinate of the center in 1/256 pixel units.
+/// @param cy256 y coordinate of the center in 1/256 pixel units.
+void arcCenter(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t &rx, int16_t &ry, int16_t phi, int16_t flags, int32_t &cx256, int32_t &cy256);
+
 
 }  // gfxDraw:: namespace
 
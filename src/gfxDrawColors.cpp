@@ -52,6 +52,34 @@ uint16_t ARGB::toColor16() {
   return ((((Red) & 0xF8) << 8) | (((Green) & 0xFC) << 3) | ((Blue) >> 3));
 }
 
+// ===== PARGB class members =====
+
+// multiply a color component by alpha/255 with rounding.
+static inline uint8_t _mul255(uint8_t c, uint8_t a) {
+  uint32_t t = c * a + 128;
+  return ((t + (t >> 8)) >> 8);
+}
+
+// divide a premultiplied color component by alpha/255 with rounding.
+static inline uint8_t _div255(uint8_t c, uint8_t a) {
+  uint32_t v = (c * 255 + a / 2) / a;
+  return ((v > 255) ? 255 : v);
+}
+
+PARGB::PARGB(ARGB color) {
+  Alpha = color.Alpha;
+  Red = _mul255(color.Red, color.Alpha);
+  Green = _mul255(color.Green, color.Alpha);
+  Blue = _mul255(color.Blue, color.Alpha);
+};
+
+ARGB PARGB::toARGB() const {
+  if (Alpha == 0) return (ARGB_TRANSPARENT);
+  if (Alpha == 255) return (ARGB(Red, Green, Blue, Alpha));
+
+  return (ARGB(_div255(Red, Alpha), _div255(Green, Alpha), _div255(Blue, Alpha), Alpha));
+}
+
 // c lang-format off
 ARGB const ARGB_BLACK (    0,    0,    0);
 ARGB const ARGB_SILVER( 0xDD, 0xDD, 0xDD);
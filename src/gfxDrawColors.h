@@ -73,6 +73,45 @@ public:
   /// @return color value.
   uint16_t toColor16();
 };
+
+
+/// @brief The PARGB class is used for a color with premultiplied alpha where the Red, Green and Blue components are
+/// already multiplied by the opacity.  Blending these colors needs only one multiplication per component, see
+/// gfxDrawBlend.h.  The layout is the same as ARGB and opaque colors have the same raw value in both classes.
+/// The components of a valid premultiplied color are not larger than the Alpha value.
+class PARGB {
+public:
+  PARGB() : raw(0) {};
+
+  /// create premultiplied color from a color.
+  PARGB(ARGB color);
+
+  union {
+    struct {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+      uint8_t Blue;
+      uint8_t Green;
+      uint8_t Red;
+      uint8_t Alpha;
+#else
+      uint8_t Alpha;
+      uint8_t Red;
+      uint8_t Green;
+      uint8_t Blue;
+#endif
+    };
+    uint32_t raw;  // equals #AArrggbb
+  };
+
+  /// @brief Compare two colors.
+  bool operator==(PARGB const &col2) const {
+    return (raw == col2.raw);
+  };
+
+  /// @brief Convert into a color with Red, Green and Blue not multiplied by Alpha.
+  /// @return color value.
+  ARGB toARGB() const;
+};
 #pragma pack(pop)
 
 
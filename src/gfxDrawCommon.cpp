@@ -12,6 +12,13 @@
 #include "gfxDraw.h"
 #include "gfxDrawCommon.h"
 
+#ifdef GFXDRAW_THREADS
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
 #ifndef GFX_TRACE
 #define GFX_TRACE(...)  // GFXDRAWTRACE(__VA_ARGS__)
 #endif
@@ -19,83 +26,53 @@
 
 namespace gfxDraw {
 
-// Proposes a next pixel of the path.
+// Proposes a next pixel of the path using a global filter.
 
-void proposePixel(int16_t x, int16_t y, fSetPixel cbDraw) {
-  static Point lastPoints[3];
+void proposePixel(int16_t x, int16_t y, const fSetPixel &cbDraw) {
+  static PixelStreamFilter filter;
 
   GFX_TRACE("proposePixel(%d, %d)", x, y);
+  filter.propose(x, y, cbDraw);
+}  // proposePixel()
 
-  if ((x == lastPoints[0].x) && (y == lastPoints[0].y)) {
-    // don't collect duplicates
-    GFX_TRACE("  duplicate!");
+// ===== Clipping
 
-  } else if (y == POINT_BREAK_Y) {
-    // draw all remaining points and invalidate lastPoints
-    GFX_TRACE("  flush!");
-    for (int n = 2; n >= 0; n--) {
-      if (lastPoints[n].y != POINT_INVALID_Y)
-        cbDraw(lastPoints[n].x, lastPoints[n].y);
-      lastPoints[n].y = POINT_INVALID_Y;
-    }  // for
+#ifdef GFXDRAW_THREADS
+thread_local ClipRect _clipRect;
+#else
+ClipRect _clipRect;
+#endif
 
-  } else if (lastPoints[0].y == POINT_BREAK_Y) {
-    lastPoints[0].x = x;
-    lastPoints[0].y = y;
+void setClipRect(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+  GFX_TRACE("setClipRect(%d/%d - %d/%d)", x0, y0, x1, y1);
+  _clipRect.x0 = x0;
+  _clipRect.y0 = y0;
+  _clipRect.x1 = x1;
+  _clipRect.y1 = (y1 < POINT_INVALID_Y) ? y1 : POINT_INVALID_Y - 1;
+}  // setClipRect()
 
-  } else {
-    // draw oldest point and shift new point in
-    if (lastPoints[2].y != POINT_INVALID_Y)
-      cbDraw(lastPoints[2].x, lastPoints[2].y);
-    lastPoints[2] = lastPoints[1];
-    lastPoints[1] = lastPoints[0];
-    lastPoints[0].x = x;
-    lastPoints[0].y = y;
-
-    if (lastPoints[1].y != POINT_INVALID_Y) {
-      bool delFlag = false;
-
-      // don't draw "corner" points
-      if ((lastPoints[0].y == lastPoints[1].y) && (abs(lastPoints[0].x - lastPoints[1].x) == 1)) {
-        delFlag = (lastPoints[1].x == lastPoints[2].x);
-      } else if ((lastPoints[0].x == lastPoints[1].x) && (abs(lastPoints[0].y - lastPoints[1].y) == 1)) {
-        delFlag = (lastPoints[1].y == lastPoints[2].y);
-      }
+void resetClipRect() {
+  _clipRect = ClipRect();
+}  // resetClipRect()
 
-      // draw between unconnected points
-      if (!delFlag) {
-        if ((abs(lastPoints[0].x - lastPoints[1].x) <= 1) && (abs(lastPoints[0].y - lastPoints[1].y) <= 1)) {
-          // points are connected -> no additional draw required
-
-        } else if ((abs(lastPoints[0].x - lastPoints[1].x) <= 2) && (abs(lastPoints[0].y - lastPoints[1].y) <= 2)) {
-          // simple interpolate new lastPoints[1]
-          // GFX_TRACE("  gap!");
-          if (lastPoints[2].y != POINT_INVALID_Y)
-            cbDraw(lastPoints[2].x, lastPoints[2].y);
-          lastPoints[2] = lastPoints[1];
-          lastPoints[1].x = (lastPoints[0].x + lastPoints[1].x) / 2;
-          lastPoints[1].y = (lastPoints[0].y + lastPoints[1].y) / 2;
-        } else if ((abs(lastPoints[0].x - lastPoints[1].x) > 2) || (abs(lastPoints[0].y - lastPoints[1].y) > 2)) {
-          // GFX_TRACE("  big gap!");
-
-          // draw a streight line from lastPoints[1] to lastPoints[0]
-          if (lastPoints[2].y != POINT_INVALID_Y)
-            cbDraw(lastPoints[2].x, lastPoints[2].y);
-          drawLine(lastPoints[1].x, lastPoints[1].y, lastPoints[0].x, lastPoints[0].y, cbDraw);
-          lastPoints[2].y = POINT_INVALID_Y;
-          lastPoints[1].y = POINT_INVALID_Y;
-          // lastPoints[0] stays.
-        }
-      }
+ClipRect getClipRect() {
+  return (_clipRect);
+}  // getClipRect()
+
+ClipScope::ClipScope(int16_t x0, int16_t y0, int16_t x1, int16_t y1)
+  : _previous(_clipRect) {
+  setClipRect(x0, y0, x1, y1);
+}
+
+ClipScope::ClipScope()
+  : _previous(_clipRect) {
+  resetClipRect();
+}
+
+ClipScope::~ClipScope() {
+  _clipRect = _previous;
+}
 
-      if (delFlag) {
-        // remove lastPoints[1];
-        lastPoints[1] = lastPoints[2];
-        lastPoints[2].y = POINT_INVALID_Y;
-      }
-    }
-  }
-};
 
 // ===== Fast but non-precise sin / cos functions
 
@@ -133,8 +110,415 @@ int32_t cos256(int32_t degree) {
   return (sin256(degree + 90));
 }
 
+// ===== Fixed-point angle functions
+
+// sin(degree) * 65536 for full degrees, used for exact results without CORDIC.
+static const int32_t tab_sin65536[] = {
+  0, 1144, 2287, 3430, 4572, 5712, 6850, 7987,
+  9121, 10252, 11380, 12505, 13626, 14742, 15855, 16962,
+  18064, 19161, 20252, 21336, 22415, 23486, 24550, 25607,
+  26656, 27697, 28729, 29753, 30767, 31772, 32768, 33754,
+  34729, 35693, 36647, 37590, 38521, 39441, 40348, 41243,
+  42126, 42995, 43852, 44695, 45525, 46341, 47143, 47930,
+  48703, 49461, 50203, 50931, 51643, 52339, 53020, 53684,
+  54332, 54963, 55578, 56175, 56756, 57319, 57865, 58393,
+  58903, 59396, 59870, 60326, 60764, 61183, 61584, 61966,
+  62328, 62672, 62997, 63303, 63589, 63856, 64104, 64332,
+  64540, 64729, 64898, 65048, 65177, 65287, 65376, 65446,
+  65496, 65526, 65536
+};
+
+// atan(2^-i) in 1/65536 degree.
+static const int32_t tab_atan65536[] = {
+  2949120, 1740967, 919879, 466945, 234379, 117304, 58666, 29335,
+  14668, 7334, 3667, 1833, 917, 458, 229, 115,
+  57, 29, 14, 7, 4, 2, 1
+};
+
+#define CORDIC_STEPS (sizeof(tab_atan65536) / sizeof(tab_atan65536[0]))
+
+// 1 / CORDIC gain scaled by 2^30.
+#define CORDIC_K30 652032874
+
+
+/// @brief Calculate the angle of a vector using the CORDIC algorithm in vectoring mode.
+int32_t atan2_65536(int64_t y, int64_t x) {
+  if ((x == 0) && (y == 0)) return (0);
+
+  int32_t angle = 0;
+  if (x < 0) {
+    // rotate by 180 degree into the right half plane.
+    x = -x;
+    y = -y;
+    angle = DEGREE65536(180);
+  }
+
+  // normalize the vector to 2^27 ... 2^28 for precision without overflow.
+  int64_t m = (x > (y < 0 ? -y : y)) ? x : (y < 0 ? -y : y);
+  while (m >= (1 << 28)) {
+    x >>= 1;
+    y >>= 1;
+    m >>= 1;
+  }
+  while (m < (1 << 19)) {
+    x <<= 8;
+    y <<= 8;
+    m <<= 8;
+  }
+  while (m < (1 << 27)) {
+    x <<= 1;
+    y <<= 1;
+    m <<= 1;
+  }
+
+  int32_t cx = (int32_t)x;
+  int32_t cy = (int32_t)y;
+  for (uint16_t i = 0; i < CORDIC_STEPS; i++) {
+    int32_t dx = (cy >> i);
+    int32_t dy = (cx >> i);
+    if (cy > 0) {
+      cx += dx;
+      cy -= dy;
+      angle += tab_atan65536[i];
+    } else {
+      cx -= dx;
+      cy += dy;
+      angle -= tab_atan65536[i];
+    }
+  }
+
+  if (angle < 0) angle += DEGREE65536(360);
+  if (angle >= DEGREE65536(360)) angle -= DEGREE65536(360);
+  return (angle);
+}  // atan2_65536()
+
+
+/// @brief Calculate sin and cos using the CORDIC algorithm in rotation mode.
+void sinCos65536(int32_t angle, int32_t &sin65536, int32_t &cos65536) {
+  angle %= DEGREE65536(360);
+  if (angle < 0) angle += DEGREE65536(360);
+
+  if ((angle & 0xFFFF) == 0) {
+    // full degrees from the table.
+    int32_t degree = angle >> 16;
+    int32_t q = degree % 90;
+    int32_t s = tab_sin65536[q];
+    int32_t c = tab_sin65536[90 - q];
+    switch (degree / 90) {
+      case 0:
+        sin65536 = s;
+        cos65536 = c;
+        break;
+      case 1:
+        sin65536 = c;
+        cos65536 = -s;
+        break;
+      case 2:
+        sin65536 = -s;
+        cos65536 = -c;
+        break;
+      default:
+        sin65536 = -c;
+        cos65536 = s;
+        break;
+    }
+    return;
+  }
+
+  // reduce to -90 ... +90 degree.
+  bool negate = false;
+  if (angle > DEGREE65536(270)) {
+    angle -= DEGREE65536(360);
+  } else if (angle > DEGREE65536(90)) {
+    angle -= DEGREE65536(180);
+    negate = true;
+  }
+
+  int32_t x = CORDIC_K30;
+  int32_t y = 0;
+  for (uint16_t i = 0; i < CORDIC_STEPS; i++) {
+    int32_t dx = (y >> i);
+    int32_t dy = (x >> i);
+    if (angle > 0) {
+      x -= dx;
+      y += dy;
+      angle -= tab_atan65536[i];
+    } else {
+      x += dx;
+      y -= dy;
+      angle += tab_atan65536[i];
+    }
+  }
+
+  // scale from 2^30 to 2^16
+  x = (x + (1 << 13)) >> 14;
+  y = (y + (1 << 13)) >> 14;
+  sin65536 = (negate ? -y : y);
+  cos65536 = (negate ? -x : x);
+}  // sinCos65536()
+
+
+/// @brief Calculate the rounded sin and cos values scaled by 1000 for rotations.
+void sinCos1000(int16_t degree, int32_t &sin1000, int32_t &cos1000) {
+#ifdef GFXDRAW_NO_FLOAT
+  int32_t s, c;
+  sinCos65536(DEGREE65536(degree), s, c);
+
+  // round half away from zero like lround
+  sin1000 = (s * 1000 + (s < 0 ? -32768 : 32768)) / 65536;
+  cos1000 = (c * 1000 + (c < 0 ? -32768 : 32768)) / 65536;
+#else
+  double radians = (degree * M_PI) / 180;
+
+  sin1000 = std::lround(sin(radians) * 1000);
+  cos1000 = std::lround(cos(radians) * 1000);
+#endif
+}  // sinCos1000()
+
+
+/// @brief integer square root, bit by bit.
+uint32_t isqrt(uint64_t v) {
+  uint64_t r = 0;
+  uint64_t bit = (uint64_t)1 << 62;
+
+  while (bit > v) bit >>= 2;
+  while (bit) {
+    if (v >= r + bit) {
+      v -= r + bit;
+      r = (r >> 1) + bit;
+    } else {
+      r >>= 1;
+    }
+    bit >>= 2;
+  }
+  return ((uint32_t)r);
+}  // isqrt()
+
 // ===== Debug helping functions... =====
 
+// ===== Parallel execution
+
+#ifdef GFXDRAW_THREADS
+
+// A simple thread pool with (GFXDRAW_THREAD_COUNT - 1) or (cores - 1) worker threads.
+// The calling thread is working on the same job so one job can run at a time.
+class _ThreadPool {
+public:
+  _ThreadPool() {
+    unsigned int cores = (GFXDRAW_THREAD_COUNT > 0) ? GFXDRAW_THREAD_COUNT : std::thread::hardware_concurrency();
+    for (unsigned int n = 1; n < cores; n++) {
+      _workers.emplace_back([this]() {
+        _work();
+      });
+    }
+  }
+
+  ~_ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _stop = true;
+    }
+    _wakeup.notify_all();
+    for (std::thread &t : _workers) t.join();
+  }
+
+  int16_t threads() {
+    return (_workers.size() + 1);
+  }
+
+  // run a job, returns false when the pool is busy.
+  bool run(int16_t count, const std::function<void(int16_t n)> &fn) {
+    std::unique_lock<std::mutex> runLock(_runMutex, std::try_to_lock);
+    if (!runLock.owns_lock()) return (false);
+
+    {
+      // workers still leaving the previous job must not take calls of the new job.
+      std::unique_lock<std::mutex> lock(_mutex);
+      _done.wait(lock, [this]() {
+        return (_active == 0);
+      });
+      _fn = &fn;
+      _next = 0;
+      _count = count;
+      _pending = count;
+      _job++;
+    }
+    _wakeup.notify_all();
+    _calls();
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _done.wait(lock, [this]() {
+      return (_pending == 0);
+    });
+    _fn = nullptr;
+    return (true);
+  }
+
+private:
+  // execute calls of the current job until all calls have been started.
+  void _calls() {
+    int16_t n;
+    while ((n = _next++) < _count) {
+      (*_fn)(n);
+      if (--_pending == 0) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _done.notify_all();
+      }
+    }
+  }
+
+  // worker thread
+  void _work() {
+    uint32_t job = 0;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _wakeup.wait(lock, [&]() {
+          return (_stop || (_job != job));
+        });
+        if (_stop) return;
+        job = _job;
+        _active++;
+      }
+      _calls();
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (--_active == 0) _done.notify_all();
+      }
+    }
+  }
+
+  std::vector<std::thread> _workers;
+  std::mutex _runMutex;
+  std::mutex _mutex;
+  std::condition_variable _wakeup;
+  std::condition_variable _done;
+  bool _stop = false;
+  uint32_t _job = 0;
+  int16_t _active = 0;  // number of workers in _calls()
+
+  const std::function<void(int16_t n)> *_fn = nullptr;
+  std::atomic<int16_t> _count{ 0 };
+  std::atomic<int16_t> _next{ 0 };
+  std::atomic<int16_t> _pending{ 0 };
+};
+
+static _ThreadPool &_threadPool() {
+  static _ThreadPool pool;
+  return (pool);
+}
+
+#endif
+
+
+int16_t _parallelThreads() {
+#ifdef GFXDRAW_THREADS
+  return (_threadPool().threads());
+#else
+  return (1);
+#endif
+}  // _parallelThreads()
+
+
+void _parallelFor(int16_t count, const std::function<void(int16_t n)> &fn) {
+#ifdef GFXDRAW_THREADS
+#ifdef GFXDRAW_STATS
+  // the calls on the worker threads count into the statistics of the drawing call of this thread.
+  _DrawStatsCounters *stats = _lastStats;
+  std::function<void(int16_t n)> job = [&](int16_t n) {
+    _DrawStatsScope scope(stats);
+    fn(n);
+  };
+#else
+  const std::function<void(int16_t n)> &job = fn;
+#endif
+  if ((count > 1) && (_threadPool().threads() > 1) && (_threadPool().run(count, job))) return;
+#endif
+  for (int16_t n = 0; n < count; n++) fn(n);
+}  // _parallelFor()
+
+
+// ===== Statistics
+
+#ifdef GFXDRAW_STATS
+
+#ifdef GFXDRAW_THREADS
+static thread_local _DrawStatsCounters _threadStats;
+thread_local _DrawStatsCounters *_lastStats = &_threadStats;
+#else
+static _DrawStatsCounters _threadStats;
+_DrawStatsCounters *_lastStats = &_threadStats;
+#endif
+
+_DrawStatsCounters _totalStats;
+thread_local int _DrawStatsScope::_depth = 0;
+
+static void _resetStats(_DrawStatsCounters &c) {
+  c.segments = c.borderPixels = c.fillPixels = 0;
+  c.edges = c.markerEdges = c.sortSize = 0;
+  c.gapFills = c.lineFallbacks = c.spriteResizes = 0;
+}
+
+_DrawStatsScope::_DrawStatsScope()
+  : _previous(_lastStats) {
+  if (_depth++ == 0) _resetStats(*_lastStats);
+}
+
+_DrawStatsScope::_DrawStatsScope(_DrawStatsCounters *counters)
+  : _previous(_lastStats) {
+  _lastStats = counters;
+  _depth++;
+}
+
+_DrawStatsScope::~_DrawStatsScope() {
+  _depth--;
+  _lastStats = _previous;
+}
+
+static DrawStats _getStats(const _DrawStatsCounters &c) {
+  DrawStats stats;
+  stats.segments = c.segments;
+  stats.borderPixels = c.borderPixels;
+  stats.fillPixels = c.fillPixels;
+  stats.edges = c.edges;
+  stats.markerEdges = c.markerEdges;
+  stats.sortSize = c.sortSize;
+  stats.gapFills = c.gapFills;
+  stats.lineFallbacks = c.lineFallbacks;
+  stats.spriteResizes = c.spriteResizes;
+  return (stats);
+}
+
+DrawStats lastDrawStats() {
+  return (_getStats(*_lastStats));
+}
+
+DrawStats totalDrawStats() {
+  return (_getStats(_totalStats));
+}
+
+void resetDrawStats() {
+  _resetStats(*_lastStats);
+  _resetStats(_totalStats);
+}
+
+#else
+
+// no statistics are collected.
+
+DrawStats lastDrawStats() {
+  return (DrawStats());
+}
+
+DrawStats totalDrawStats() {
+  return (DrawStats());
+}
+
+void resetDrawStats() {}
+
+#endif
+
+
 void dumpPoints(std::vector<Point> &points) {
   GFX_TRACE("\nPoints:");
   size_t size = points.size();
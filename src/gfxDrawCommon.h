@@ -24,15 +24,47 @@
 #endif
 
 #include <functional>
+#include <type_traits>
+#include <cstddef>
+
+// Multi-threading is used for filling large paths on host builds.
+// Define GFXDRAW_NO_THREADS to disable it.
+#if !defined(ARDUINO) && !defined(GFXDRAW_NO_THREADS)
+#define GFXDRAW_THREADS
+#endif
+
+// Number of threads for parallel drawing, 0 = number of cores.
+#ifndef GFXDRAW_THREAD_COUNT
+#define GFXDRAW_THREAD_COUNT 0
+#endif
+
+// Arcs, rotations and angles are calculated using fixed-point integer arithmetics when GFXDRAW_NO_FLOAT is defined.
+// This avoids the slow software floating point functions on processors without FPU.
+// #define GFXDRAW_NO_FLOAT
+
+// Statistics counters of the drawing functions are available when GFXDRAW_STATS is defined.
+// #define GFXDRAW_STATS
+
+#if defined(GFXDRAW_STATS) && defined(GFXDRAW_THREADS)
+#include <atomic>
+#endif
 
 namespace gfxDraw {
 
 /// @brief Callback function definition to address a pixel on a display
 typedef std::function<void(int16_t x, int16_t y)> fSetPixel;
 
+/// @brief Callback function definition to address a horizontal sequence of pixels from x0 to x1 (both including) on the line y.
+/// This allows using fast line functions like writeFastHLine or memset on a framebuffer row for filling.
+typedef std::function<void(int16_t x0, int16_t x1, int16_t y)> fDrawSpan;
+
 /// @brief Callback function definition to change a pixel on a display by applying the given color.
 typedef std::function<void(int16_t x, int16_t y, ARGB color)> fDrawPixel;
 
+/// @brief Callback function definition to draw a horizontal sequence of len pixels starting at x on the line y.
+/// This allows using block transfer functions like draw16bitRGBBitmap of the display driver.
+typedef std::function<void(int16_t x, int16_t y, const ARGB *pixels, int16_t len)> fDrawRow;
+
 /// @brief Callback function definition to change a pixel on a display by applying the given color.
 typedef std::function<ARGB(ARGB color)> fMapColor;
 
@@ -44,6 +76,135 @@ typedef std::function<void(int16_t &x, int16_t &y)> fTransform;
 // typedef std::function<ARGB(int16_t x, int16_t y)> fReadPixel;
 
 
+/// ===== Callback helpers for the templated drawing functions =====
+
+// The drawing functions are also available as templates that accept any callable (lambda, function pointer, functor)
+// so the compiler can inline the pixel callback into the inner loops.
+// The std::function based functions are kept and are thin wrappers to the templates.
+
+/// @brief true for std::function types.
+template<typename T>
+struct _isStdFunction : std::false_type {};
+
+template<typename R, typename... Args>
+struct _isStdFunction<std::function<R(Args...)>> : std::true_type {};
+
+/// @brief Check if a callback is given.
+/// A nullptr, a null function pointer or an empty std::function is not given, any other callable is.
+template<typename TCallback>
+inline bool _isCallback(const TCallback &cb) {
+  if constexpr (std::is_same_v<TCallback, std::nullptr_t>) {
+    return (false);
+  } else if constexpr (std::is_pointer_v<TCallback> || _isStdFunction<TCallback>::value) {
+    return (cb != nullptr);
+  } else {
+    // functions, lambdas and functors
+    return (true);
+  }
+}
+
+/// @brief Pass a horizontal sequence of pixels from x0 to x1 (both including) to a span or a pixel callback.
+/// @param cb A fDrawSpan-like or fSetPixel-like callable. Nothing is drawn for nullptr.
+template<typename TCallback>
+inline void _drawSpan(TCallback &cb, int16_t x0, int16_t x1, int16_t y) {
+  if constexpr (std::is_same_v<std::remove_cv_t<TCallback>, std::nullptr_t>) {
+    // no callback
+  } else if constexpr (std::is_invocable_v<TCallback &, int16_t, int16_t, int16_t>) {
+    cb(x0, x1, y);
+  } else {
+    static_assert(std::is_invocable_v<TCallback &, int16_t, int16_t>,
+                  "the callback must be callable like fDrawSpan(x0, x1, y) or fSetPixel(x, y)");
+    while (x0 <= x1) cb(x0++, y);
+  }
+}
+
+
+
+
+/// ===== Statistics =====
+
+/// @brief Counters of the drawing functions.
+/// The counters are only collected when the library is compiled with GFXDRAW_STATS defined.
+struct DrawStats {
+  /// @brief Segments processed by drawSegments.
+  uint32_t segments = 0;
+  /// @brief Pixels passed to the border callback, also the stroke of circles and the pixels of text.
+  uint32_t borderPixels = 0;
+  /// @brief Pixels passed to the fill callback.
+  uint32_t fillPixels = 0;
+  /// @brief Edge records created by the scanline fill.
+  uint32_t edges = 0;
+  /// @brief Marker edges inserted by slopeEdges for local extremes.
+  uint32_t markerEdges = 0;
+  /// @brief Number of edges sorted by the scanline fill.
+  uint32_t sortSize = 0;
+  /// @brief Missing single pixels added by the PixelStreamFilter.
+  uint32_t gapFills = 0;
+  /// @brief Bigger gaps closed by the PixelStreamFilter using drawLine.
+  uint32_t lineFallbacks = 0;
+  /// @brief Reallocations of the Sprite data.
+  uint32_t spriteResizes = 0;
+};
+
+/// @brief Get the statistics of the last drawing call like drawSegments, fillSegments, drawCircle, drawRect, drawText
+/// or a widget draw.
+/// Drawing functions called by other drawing functions are included in the outer call.
+DrawStats lastDrawStats();
+
+/// @brief Get the statistics of all drawing calls since start or since resetDrawStats().
+DrawStats totalDrawStats();
+
+/// @brief Reset all statistics counters.
+void resetDrawStats();
+
+#ifdef GFXDRAW_STATS
+
+#ifdef GFXDRAW_THREADS
+typedef std::atomic<uint32_t> _StatsCounter;
+#else
+typedef uint32_t _StatsCounter;
+#endif
+
+/// @brief Internal counters with the same fields as DrawStats that can be counted from multiple threads.
+struct _DrawStatsCounters {
+  _StatsCounter segments, borderPixels, fillPixels, edges, markerEdges, sortSize, gapFills, lineFallbacks, spriteResizes;
+};
+
+/// @brief The counters of the last drawing call.
+/// With GFXDRAW_THREADS every thread counts its own drawing calls.
+#ifdef GFXDRAW_THREADS
+extern thread_local _DrawStatsCounters *_lastStats;
+#else
+extern _DrawStatsCounters *_lastStats;
+#endif
+
+/// @brief The counters of all drawing calls of all threads.
+extern _DrawStatsCounters _totalStats;
+
+/// @brief A _DrawStatsScope marks a drawing call and resets the statistics of the last call when it is not nested.
+class _DrawStatsScope {
+public:
+  _DrawStatsScope();
+
+  /// @brief Continue a drawing call of another thread, e.g. in a parallel job, using the counters of that call.
+  _DrawStatsScope(_DrawStatsCounters *counters);
+
+  ~_DrawStatsScope();
+
+private:
+  _DrawStatsCounters *_previous;  // counters of this thread before the scope
+  static thread_local int _depth;  // nesting of the drawing calls in this thread
+};
+
+#define GFXDRAW_STAT(counter, n) (gfxDraw::_lastStats->counter += (n), gfxDraw::_totalStats.counter += (n))
+#define GFXDRAW_STATS_SCOPE(name) gfxDraw::_DrawStatsScope name
+
+#else
+
+#define GFXDRAW_STAT(counter, n)
+#define GFXDRAW_STATS_SCOPE(name)
+
+#endif
 
 
 /// ===== Points =====
@@ -153,18 +314,206 @@ public:
 };
 
 
-/// @brief Propose a next pixel of the path.
-/// @param x X value of the pixel
-/// @param y Y value of the pixel
-/// @param cbDraw callback function for the effective pixels of the path.
+/// ===== Clipping =====
+
+/// @brief A rectangle of pixels from (x0, y0) to (x1, y1), both including, that restricts drawing.
+/// The drawing functions skip lines, spans and glyphs outside the clip rectangle and don't pass the pixels outside to
+/// the callbacks so the callbacks don't need to check the display bounds.
+struct ClipRect {
+  int16_t x0 = INT16_MIN;
+  int16_t y0 = INT16_MIN;
+  int16_t x1 = INT16_MAX;
+  int16_t y1 = POINT_INVALID_Y - 1;
+
+  /// @brief Check if a pixel is inside.
+  bool contains(int16_t x, int16_t y) const {
+    return ((x >= x0) && (x <= x1) && (y >= y0) && (y <= y1));
+  }
+
+  /// @brief Check if any pixel of a rectangle from (left, top) to (right, bottom) is inside.
+  bool intersects(int16_t left, int16_t top, int16_t right, int16_t bottom) const {
+    return ((left <= x1) && (right >= x0) && (top <= y1) && (bottom >= y0));
+  }
+
+  /// @brief Check if all pixels of a rectangle from (left, top) to (right, bottom) are inside.
+  bool covers(int16_t left, int16_t top, int16_t right, int16_t bottom) const {
+    return ((left >= x0) && (right <= x1) && (top >= y0) && (bottom <= y1));
+  }
+
+  /// @brief Restrict a horizontal sequence of pixels to the clip rectangle.
+  /// @return false when no pixel is inside.
+  bool clipSpan(int16_t &left, int16_t &right, int16_t y) const {
+    if ((y < y0) || (y > y1)) return (false);
+    if (left < x0) left = x0;
+    if (right > x1) right = x1;
+    return (left <= right);
+  }
+};
+
+/// @brief The current clip rectangle used by the drawing functions.
+/// With GFXDRAW_THREADS every thread has its own clip rectangle so threads can draw in their own ClipScope.
+#ifdef GFXDRAW_THREADS
+extern thread_local ClipRect _clipRect;
+#else
+extern ClipRect _clipRect;
+#endif
+
+/// @brief Restrict all following drawing to the pixels from (x0, y0) to (x1, y1), both including.
+/// This is typically the size of the display or the area of a scrolling widget.
+void setClipRect(int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+
+/// @brief Remove the clip rectangle.
+void resetClipRect();
+
+/// @brief Get the current clip rectangle.
+ClipRect getClipRect();
+
+/// @brief A ClipScope sets the clip rectangle for the drawing calls in a block and restores the previous one when the
+/// block is left.
+class ClipScope {
+public:
+  /// @brief Set the clip rectangle to the pixels from (x0, y0) to (x1, y1), both including.
+  ClipScope(int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+
+  /// @brief Remove the clip rectangle.
+  ClipScope();
+
+  ~ClipScope();
+
+private:
+  ClipRect _previous;
+};
+
+
+// The line drawing is used by the PixelStreamFilter to close bigger gaps without clipping, see gfxDrawLine.h
+template<typename TSetPixel>
+void _drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, TSetPixel &&cbDraw);
+
+
+/// @brief The PixelStreamFilter receives the pixels of a path in drawing order and passes the effective pixels to a
+/// callback function.
 ///
 /// @details
-/// This function buffers up to 3 pixels and analysis for pixel unwanted sequences and missing pixels.
+/// The filter buffers up to 3 pixels and analyses them for unwanted pixel sequences and missing pixels.
 /// * ignore duplicates
 /// * remove corner-type pixels
 /// * fill missing 1-pixel
 /// * draw streight line when more pixels are missing.
-void proposePixel(int16_t x, int16_t y, fSetPixel cbDraw);
+///
+/// All state is held in the filter object so every drawing function uses its own local filter
+/// and the drawing functions are re-entrant.
+class PixelStreamFilter {
+public:
+  /// @brief Propose a next pixel of the path.
+  /// @param x X value of the pixel
+  /// @param y Y value of the pixel. POINT_BREAK_Y flushes all buffered pixels.
+  /// @param cbDraw callback function for the effective pixels of the path.
+  template<typename TSetPixel>
+  void propose(int16_t x, int16_t y, TSetPixel &cbDraw) {
+    Point *lastPoints = _lastPoints;
+
+    if ((x == lastPoints[0].x) && (y == lastPoints[0].y)) {
+      // don't collect duplicates
+
+    } else if (y == POINT_BREAK_Y) {
+      flush(cbDraw);
+
+    } else if (lastPoints[0].y == POINT_BREAK_Y) {
+      lastPoints[0].x = x;
+      lastPoints[0].y = y;
+
+    } else {
+      // draw oldest point and shift new point in
+      if (lastPoints[2].y != POINT_INVALID_Y)
+        cbDraw(lastPoints[2].x, lastPoints[2].y);
+      lastPoints[2] = lastPoints[1];
+      lastPoints[1] = lastPoints[0];
+      lastPoints[0].x = x;
+      lastPoints[0].y = y;
+
+      if (lastPoints[1].y != POINT_INVALID_Y) {
+        bool delFlag = false;
+
+        // don't draw "corner" points
+        if ((lastPoints[0].y == lastPoints[1].y) && (abs(lastPoints[0].x - lastPoints[1].x) == 1)) {
+          delFlag = (lastPoints[1].x == lastPoints[2].x);
+        } else if ((lastPoints[0].x == lastPoints[1].x) && (abs(lastPoints[0].y - lastPoints[1].y) == 1)) {
+          delFlag = (lastPoints[1].y == lastPoints[2].y);
+        }
+
+        // draw between unconnected points
+        if (!delFlag) {
+          if ((abs(lastPoints[0].x - lastPoints[1].x) <= 1) && (abs(lastPoints[0].y - lastPoints[1].y) <= 1)) {
+            // points are connected -> no additional draw required
+
+          } else if ((abs(lastPoints[0].x - lastPoints[1].x) <= 2) && (abs(lastPoints[0].y - lastPoints[1].y) <= 2)) {
+            // simple interpolate new lastPoints[1]
+            GFXDRAW_STAT(gapFills, 1);
+            if (lastPoints[2].y != POINT_INVALID_Y)
+              cbDraw(lastPoints[2].x, lastPoints[2].y);
+            lastPoints[2] = lastPoints[1];
+            lastPoints[1].x = (lastPoints[0].x + lastPoints[1].x) / 2;
+            lastPoints[1].y = (lastPoints[0].y + lastPoints[1].y) / 2;
+
+          } else {
+            // draw a streight line from lastPoints[1] to lastPoints[0]
+            GFXDRAW_STAT(lineFallbacks, 1);
+            if (lastPoints[2].y != POINT_INVALID_Y)
+              cbDraw(lastPoints[2].x, lastPoints[2].y);
+            _drawLine<TSetPixel &>(lastPoints[1].x, lastPoints[1].y, lastPoints[0].x, lastPoints[0].y, cbDraw);
+            lastPoints[2].y = POINT_INVALID_Y;
+            lastPoints[1].y = POINT_INVALID_Y;
+            // lastPoints[0] stays.
+          }
+        }
+
+        if (delFlag) {
+          // remove lastPoints[1];
+          lastPoints[1] = lastPoints[2];
+          lastPoints[2].y = POINT_INVALID_Y;
+        }
+      }
+    }
+  }  // propose()
+
+
+  /// @brief Draw all remaining buffered pixels and reset the filter.
+  /// @param cbDraw callback function for the effective pixels of the path.
+  template<typename TSetPixel>
+  void flush(TSetPixel &cbDraw) {
+    for (int n = 2; n >= 0; n--) {
+      if (_lastPoints[n].y != POINT_INVALID_Y)
+        cbDraw(_lastPoints[n].x, _lastPoints[n].y);
+      _lastPoints[n].y = POINT_INVALID_Y;
+    }  // for
+  }  // flush()
+
+private:
+  /// @brief the last 3 proposed pixels, [0] is the newest one.
+  Point _lastPoints[3];
+};
+
+
+/// @brief Propose a next pixel of the path.
+/// @param x X value of the pixel
+/// @param y Y value of the pixel
+/// @param cbDraw callback function for the effective pixels of the path.
+///
+/// @details
+/// This function is using a single static PixelStreamFilter and is therefore not re-entrant.
+/// It is kept for compatibility, the drawing functions of the library use a local PixelStreamFilter.
+void proposePixel(int16_t x, int16_t y, const fSetPixel &cbDraw);
+
+/// @brief Get the number of threads available for parallel drawing.
+/// @return 1 when multi-threading is not available.
+int16_t _parallelThreads();
+
+/// @brief Call fn(0) ... fn(count-1) in parallel on a thread pool.
+/// The calls are done in order by the calling thread when multi-threading is not available
+/// or the thread pool is busy.
+/// @param count number of calls
+/// @param fn function to be called
+void _parallelFor(int16_t count, const std::function<void(int16_t n)> &fn);
 
 /// @brief Print a vector of Points on the output.
 /// @param points vector of Points.
@@ -178,6 +527,36 @@ int32_t cos256(int32_t degree);
 
 #define SCALE256(v) ((v + 127) >> 8)
 
+// ===== Fixed-point angle functions
+
+// Angles are given in 1/65536 degree, results of sin and cos in 1/65536.
+
+/// @brief Convert degrees into a fixed-point angle.
+#define DEGREE65536(degree) ((int32_t)(degree) * 65536)
+
+/// @brief Calculate the angle of a vector using the CORDIC algorithm.
+/// @param y y-value of the vector.
+/// @param x x-value of the vector.
+/// @return angle in 1/65536 degree in range 0 ... 360*65536 - 1.
+int32_t atan2_65536(int64_t y, int64_t x);
+
+/// @brief Calculate sin and cos using the CORDIC algorithm.
+/// @param angle angle in 1/65536 degree.
+/// @param sin65536 sin value scaled by 65536.
+/// @param cos65536 cos value scaled by 65536.
+void sinCos65536(int32_t angle, int32_t &sin65536, int32_t &cos65536);
+
+/// @brief Calculate the rounded sin and cos values scaled by 1000 for rotations.
+/// @param degree angle in degree.
+/// @param sin1000 sin value scaled by 1000.
+/// @param cos1000 cos value scaled by 1000.
+void sinCos1000(int16_t degree, int32_t &sin1000, int32_t &cos1000);
+
+/// @brief integer square root.
+/// @param v value
+/// @return the largest integer r with r*r <= v.
+uint32_t isqrt(uint64_t v);
+
 
 }  // gfxDraw:: namespace
 
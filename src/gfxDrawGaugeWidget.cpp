@@ -19,7 +19,7 @@
 namespace gfxDraw {
 
 // See https://reference.arduino.cc/reference/en/language/functions/math/constrain/
-float constrain_float(float value, float in_min, float in_max) {
+GaugeValue constrain_value(GaugeValue value, GaugeValue in_min, GaugeValue in_max) {
   if (value < in_min) value = in_min;
   if (value > in_max) value = in_max;
   return (value);
@@ -27,9 +27,22 @@ float constrain_float(float value, float in_min, float in_max) {
 
 
 // See https://reference.arduino.cc/reference/en/language/functions/math/map/
-int16_t map(float value, float in_min, float in_max, int16_t out_min, int16_t out_max) {
+int16_t map(GaugeValue value, GaugeValue in_min, GaugeValue in_max, int16_t out_min, int16_t out_max) {
+#ifdef GFXDRAW_NO_FLOAT
+  // rounded integer division, half away from zero like lround.
+  int64_t num = (int64_t)(value - in_min) * (out_max - out_min);
+  int64_t den = (in_max - in_min);
+  if (den == 0) return (out_min);
+  if (den < 0) {
+    num = -num;
+    den = -den;
+  }
+  int64_t result = (num + (num < 0 ? -den : den) / 2) / den + out_min;
+  return (static_cast<int16_t>(result));
+#else
   float result = (value - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
   return (static_cast<int16_t>(std::lround(result)));
+#endif
 }
 
 
@@ -51,25 +64,26 @@ gfxDrawGaugeWidget::gfxDrawGaugeWidget(gfxDrawGaugeConfig *c) {
 }  // gfxDrawGaugeWidget()
 
 
-void gfxDrawGaugeWidget::addSegment(float minValue, float maxValue, ARGB color) {
+void gfxDrawGaugeWidget::addSegment(GaugeValue minValue, GaugeValue maxValue, ARGB color) {
   _GFXDrawGaugeSegment s;
 
-  minValue = constrain_float(minValue, _conf.minValue, _conf.maxValue);
+  minValue = constrain_value(minValue, _conf.minValue, _conf.maxValue);
   s.minAngle = map(minValue, _conf.minValue, _conf.maxValue, _conf.minAngle, _conf.maxAngle);
 
-  maxValue = constrain_float(maxValue, _conf.minValue, _conf.maxValue);
+  maxValue = constrain_value(maxValue, _conf.minValue, _conf.maxValue);
   s.maxAngle = map(maxValue, _conf.minValue, _conf.maxValue, _conf.minAngle, _conf.maxAngle),
   s.color = color;
   _segments.push_back(s);
 }
 
-void gfxDrawGaugeWidget::setValue(float value) {
-  value = constrain_float(value, _conf.minValue, _conf.maxValue);
+void gfxDrawGaugeWidget::setValue(GaugeValue value) {
+  value = constrain_value(value, _conf.minValue, _conf.maxValue);
   _valueAngle = map(value, _conf.minValue, _conf.maxValue, _conf.minAngle, _conf.maxAngle);
 }  // setValue()
 
 
 void gfxDrawGaugeWidget::draw(gfxDraw::fDrawPixel cbDraw) {
+  GFXDRAW_STATS_SCOPE(statsScope);
   ARGB drawColor;
   auto drawHelper = [&](int16_t x, int16_t y) {
     cbDraw(x, y, drawColor);
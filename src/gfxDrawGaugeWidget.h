@@ -22,6 +22,14 @@ namespace gfxDraw {
 // Matrix type definition for transformation using 1000 factor and numbers.
 typedef int32_t Matrix1000[3][3];
 
+#ifdef GFXDRAW_NO_FLOAT
+/// @brief Type of the values shown by a gauge, integer values in float-free builds.
+typedef int32_t GaugeValue;
+#else
+/// @brief Type of the values shown by a gauge.
+typedef float GaugeValue;
+#endif
+
 
 /// @brief A gfxDrawGaugeWidget is used to define the dimensions, features and colors to draw gauges.
 
@@ -43,9 +51,9 @@ public:
   ARGB segmentColor = 0xFF6699FF;
 
   /// @brief minimal value that the gauge can show.
-  float minValue = 0;
+  GaugeValue minValue = 0;
   /// @brief maximal value that the gauge can show.
-  float maxValue = 100;
+  GaugeValue maxValue = 100;
 
   /// @brief minimal overall anagle for the gauge segments.
   int16_t minAngle = 40;
@@ -59,7 +67,7 @@ public:
 
   uint16_t scaleRadius = 100;
   uint16_t scaleWidth = 5;
-  float scaleSteps = 0;  // no scale with scaleSteps == 0
+  GaugeValue scaleSteps = 0;  // no scale with scaleSteps == 0
 
   const char *pointerPath = nullptr;
 };
@@ -75,11 +83,11 @@ public:
   /// @param minValue minimal value for the segment.
   /// @param maxValue maximal value for the segment.
   /// @param color The color for the segment.
-  void addSegment(float minValue, float maxValue, ARGB color);
+  void addSegment(GaugeValue minValue, GaugeValue maxValue, ARGB color);
 
   /// @brief set the current value to be displayed.
   /// @param value The value.
-  void setValue(float value);
+  void setValue(GaugeValue value);
 
   /// @brief Draw the widget
   /// @param cbDraw Pixel drawing callback function
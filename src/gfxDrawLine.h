@@ -20,12 +20,12 @@
 namespace gfxDraw {
 
 /// @brief Draw a line using the most efficient algorithm
+/// Lines with a stroke width can be drawn using drawSegments with a width.
 /// @param x0 Starting Point X coordinate.
 /// @param y0 Starting Point Y coordinate.
 /// @param x1 Ending Point X coordinate.
 /// @param y1 Ending Point Y coordinate.
 /// @param cbDraw Callback with coordinates of line pixels.
-/// @param w Width of line.
 void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, fSetPixel cbDraw);
 
 
@@ -35,6 +35,184 @@ void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, fSetPixel cbDraw);
 /// @param cbDraw Callback with coordinates of line pixels.
 void drawLine(Point &p1, Point &p2, fSetPixel cbDraw);
 
+
+/// @brief Draw all pixels of a line without clipping.
+/// This is used for tracing paths where the pixels outside the clip rectangle are required for filling.
+/// @param x0 Starting Point X coordinate.
+/// @param y0 Starting Point Y coordinate.
+/// @param x1 Ending Point X coordinate.
+/// @param y1 Ending Point Y coordinate.
+/// @param cbDraw Callable with coordinates of line pixels.
+template<typename TSetPixel>
+void _drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, TSetPixel &&cbDraw) {
+  int16_t delta_x = abs(x1 - x0);
+  int16_t delta_y = abs(y1 - y0);
+  int16_t step_x = (x0 < x1) ? 1 : -1;
+  int16_t step_y = (y0 < y1) ? 1 : -1;
+
+  if (x0 == x1) {
+    // fast draw vertical lines
+    int16_t endY = y1 + step_y;
+    for (int16_t y = y0; y != endY; y += step_y) {
+      cbDraw(x0, y);
+    }
+
+  } else if (y0 == y1) {
+    // fast draw horizontal lines
+    int16_t endX = x1 + step_x;
+    for (int16_t x = x0; x != endX; x += step_x) {
+      cbDraw(x, y0);
+    }
+
+  } else {
+    int16_t err = delta_x - delta_y;
+
+    while (true) {
+      cbDraw(x0, y0);
+      if ((x0 == x1) && (y0 == y1)) break;
+
+      int16_t err2 = err << 1;
+
+      if (err2 > -delta_y) {
+        err -= delta_y;
+        x0 += step_x;
+      }
+      if (err2 < delta_x) {
+        err += delta_x;
+        y0 += step_y;
+      }
+    }
+  }
+}  // _drawLine()
+
+
+/// @brief Draw the pixels of a line inside the clip rectangle.
+/// The first and last visible pixels are calculated up front from the line parameters so the pixels are the same as
+/// without clipping and no pixels outside the clip rectangle are visited.
+template<typename TSetPixel>
+void _drawClippedLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, const ClipRect &clip, TSetPixel &cbDraw) {
+  int32_t dx = abs(x1 - x0);
+  int32_t dy = abs(y1 - y0);
+  int32_t sx = (x0 < x1) ? 1 : -1;
+  int32_t sy = (y0 < y1) ? 1 : -1;
+
+  // The line is walked by the major axis a with the steps k = 0...da.
+  // The minor axis b is advanced floor((2 * k * db + da - 1) / (2 * da)) times after k steps.
+  bool xMajor = (dx >= dy);
+  int32_t da = xMajor ? dx : dy;
+  int32_t db = xMajor ? dy : dx;
+
+  // steps on an axis from p0 in direction s until the pixels are inside the range lo...hi.
+  auto stepRange = [](int32_t p0, int32_t s, int32_t lo, int32_t hi, int32_t &from, int32_t &to) {
+    from = (s > 0) ? (lo - p0) : (p0 - hi);
+    to = (s > 0) ? (hi - p0) : (p0 - lo);
+  };
+
+  int32_t kFrom, kTo, jFrom, jTo;
+  if (xMajor) {
+    stepRange(x0, sx, clip.x0, clip.x1, kFrom, kTo);
+    stepRange(y0, sy, clip.y0, clip.y1, jFrom, jTo);
+  } else {
+    stepRange(y0, sy, clip.y0, clip.y1, kFrom, kTo);
+    stepRange(x0, sx, clip.x0, clip.x1, jFrom, jTo);
+  }
+
+  // restrict the major steps to the minor steps inside the clip rectangle
+  if (kFrom < 0) kFrom = 0;
+  if (kTo > da) kTo = da;
+  if (jFrom > 0) {
+    int64_t k = ((2 * (int64_t)jFrom * da) - da + 1 + (2 * db) - 1) / (2 * db);
+    if (k > kFrom) kFrom = (int32_t)k;
+  }
+  if (jTo < db) {
+    if (jTo < 0) return;
+    int64_t k = ((2 * (int64_t)jTo * da) + da) / (2 * db);
+    if (k < kTo) kTo = (int32_t)k;
+  }
+  if (kFrom > kTo) return;
+
+  // continue the line at the first visible pixel.
+  int32_t j = (int32_t)(((2 * (int64_t)kFrom * db) + da - 1) / (2 * da));
+  int32_t stepsX = xMajor ? kFrom : j;
+  int32_t stepsY = xMajor ? j : kFrom;
+  int16_t x = x0 + sx * stepsX;
+  int16_t y = y0 + sy * stepsY;
+  int32_t err = dx - dy - (stepsX * dy) + (stepsY * dx);
+
+  for (int32_t k = kFrom;; k++) {
+    cbDraw(x, y);
+    if (k == kTo) break;
+
+    int32_t err2 = err * 2;
+    if (err2 > -dy) {
+      err -= dy;
+      x += sx;
+    }
+    if (err2 < dx) {
+      err += dx;
+      y += sy;
+    }
+  }
+}  // _drawClippedLine()
+
+
+/// @brief Draw a line using the most efficient algorithm with any callable as pixel callback.
+/// The callback can be inlined by the compiler.
+/// Only the pixels inside the clip rectangle are drawn.
+/// @param x0 Starting Point X coordinate.
+/// @param y0 Starting Point Y coordinate.
+/// @param x1 Ending Point X coordinate.
+/// @param y1 Ending Point Y coordinate.
+/// @param cbDraw Callable with coordinates of line pixels.
+template<typename TSetPixel>
+void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, TSetPixel &&cbDraw) {
+  const ClipRect &clip = _clipRect;
+  int16_t left = (x0 < x1) ? x0 : x1;
+  int16_t right = (x0 < x1) ? x1 : x0;
+  int16_t top = (y0 < y1) ? y0 : y1;
+  int16_t bottom = (y0 < y1) ? y1 : y0;
+
+  if (clip.covers(left, top, right, bottom)) {
+    _drawLine<TSetPixel &>(x0, y0, x1, y1, cbDraw);
+
+  } else if (!clip.intersects(left, top, right, bottom)) {
+    // nothing to draw
+
+  } else if (x0 == x1) {
+    // vertical lines are cut at the clip borders
+    if (top < clip.y0) top = clip.y0;
+    if (bottom > clip.y1) bottom = clip.y1;
+    if (y0 < y1) {
+      _drawLine<TSetPixel &>(x0, top, x0, bottom, cbDraw);
+    } else {
+      _drawLine<TSetPixel &>(x0, bottom, x0, top, cbDraw);
+    }
+
+  } else if (y0 == y1) {
+    // horizontal lines are cut at the clip borders
+    if (left < clip.x0) left = clip.x0;
+    if (right > clip.x1) right = clip.x1;
+    if (x0 < x1) {
+      _drawLine<TSetPixel &>(left, y0, right, y0, cbDraw);
+    } else {
+      _drawLine<TSetPixel &>(right, y0, left, y0, cbDraw);
+    }
+
+  } else {
+    _drawClippedLine(x0, y0, x1, y1, clip, cbDraw);
+  }
+}  // drawLine()
+
+
+/// @brief Draw a line using the most efficient algorithm with any callable as pixel callback.
+/// @param p1 Starting Point
+/// @param p2 Ending Point
+/// @param cbDraw Callable with coordinates of line pixels.
+template<typename TSetPixel>
+void drawLine(Point &p1, Point &p2, TSetPixel &&cbDraw) {
+  drawLine(p1.x, p1.y, p2.x, p2.y, cbDraw);
+}
+
 }  // gfxDraw:: namespace
 
 
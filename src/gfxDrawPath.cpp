@@ -22,18 +22,15 @@
 #define SLOPE_RAISING 2
 #define SLOPE_HORIZONTAL 3
 
+// miter joins longer than MITER_LIMIT * stroke width are drawn as bevel joins like the SVG default stroke-miterlimit.
+#define MITER_LIMIT 4
+
 namespace gfxDraw {
 // ===== internal class definitions =====
 
 
 // ===== Segments implementation =====
 
-Segment::Segment(Type _type, int16_t p1, int16_t p2) {
-  type = _type;
-  p[0] = p1;
-  p[1] = p2;
-}
-
 Segment Segment::createMove(int16_t x, int16_t y) {
   return (Segment(Type::Move, x, y));
 }
@@ -87,29 +84,37 @@ void dumpSegments(std::vector<Segment> &vSeg) {
 /// @brief Scale the points of a path by factor
 /// @param segments
 /// @param f100
-void scaleSegments(std::vector<Segment> &segments, int16_t factor, int16_t base) {
+void scaleSegments(Segment *segments, size_t count, int16_t factor, int16_t base) {
   if (factor != base) {
-    transformSegments(segments, [&](int16_t &x, int16_t &y) {
+    transformSegments(segments, count, [&](int16_t &x, int16_t &y) {
       x = ((x * factor) + (base / 2)) / base;
       y = ((y * factor) + (base / 2)) / base;
     });
   }
 }  // scaleSegments()
 
+void scaleSegments(std::vector<Segment> &segments, int16_t factor, int16_t base) {
+  scaleSegments(segments.data(), segments.size(), factor, base);
+}  // scaleSegments()
+
 
 /// @brief move all points by the given offset in x and y.
 /// @param segments Segment vector to be changed
 /// @param dx X-Offset
 /// @param dy Y-Offset
-void moveSegments(std::vector<Segment> &segments, int16_t dx, int16_t dy) {
+void moveSegments(Segment *segments, size_t count, int16_t dx, int16_t dy) {
   if ((dx != 0) || (dy != 0)) {
-    transformSegments(segments, [&](int16_t &x, int16_t &y) {
+    transformSegments(segments, count, [&](int16_t &x, int16_t &y) {
       x += dx;
       y += dy;
     });
   }
 }  // moveSegments()
 
+void moveSegments(std::vector<Segment> &segments, int16_t dx, int16_t dy) {
+  moveSegments(segments.data(), segments.size(), dx, dy);
+}  // moveSegments()
+
 
 /// @brief move all points by the given offset in x and y.
 /// @param segments Segment vector to be changed
@@ -119,15 +124,13 @@ void moveSegments(std::vector<Segment> &segments, Point moveVector) {
 };
 
 
-void rotateSegments(std::vector<Segment> &segments, int16_t angle) {
+void rotateSegments(Segment *segments, size_t count, int16_t angle) {
   if (angle != 0) {
 
-    double radians = (angle * M_PI) / 180;
-
-    int32_t sinFactor1000 = std::lround(sin(radians) * 1000);
-    int32_t cosFactor1000 = std::lround(cos(radians) * 1000);
+    int32_t sinFactor1000, cosFactor1000;
+    sinCos1000(angle, sinFactor1000, cosFactor1000);
 
-    transformSegments(segments, [&](int16_t &x, int16_t &y) {
+    transformSegments(segments, count, [&](int16_t &x, int16_t &y) {
       int32_t tx = cosFactor1000 * x - sinFactor1000 * y;
       int32_t ty = sinFactor1000 * x + cosFactor1000 * y;
       x = (tx / 1000);
@@ -136,16 +139,22 @@ void rotateSegments(std::vector<Segment> &segments, int16_t angle) {
   }
 }  // rotateSegments()
 
+void rotateSegments(std::vector<Segment> &segments, int16_t angle) {
+  rotateSegments(segments.data(), segments.size(), angle);
+}  // rotateSegments()
+
 
 /// @brief transform all points in the segment list.
-/// @param segments Segment vector to be changed
-void transformSegments(std::vector<Segment> &segments, fTransform cbTransform) {
+/// @param segments Segments to be changed
+/// @param count Number of segments
+void transformSegments(Segment *segments, size_t count, fTransform cbTransform) {
   int16_t p0_x, p0_y, p1_x, p1_y;
   int16_t angle;
   int32_t scale1000;
   bool scaleKnown = false;
 
-  for (Segment &pSeg : segments) {
+  for (size_t n = 0; n < count; n++) {
+    Segment &pSeg = segments[n];
 
     switch (pSeg.type) {
       case Segment::Type::Move:
@@ -183,8 +192,13 @@ void transformSegments(std::vector<Segment> &segments, fTransform cbTransform) {
             }
 
           } else {
+#ifdef GFXDRAW_NO_FLOAT
+            // round(sqrt(v)) == (floor(sqrt(4 * v)) + 1) / 2
+            scale1000 = (isqrt(4 * ((int64_t)p1_x * p1_x + (int64_t)p1_y * p1_y)) + 1) / 2;
+#else
             double p1_length = sqrt((p1_x * p1_x) + (p1_y * p1_y));
             scale1000 = std::lround(p1_length);
+#endif
             angle = vectorAngle(p1_x, p1_y);
           }
           scaleKnown = true;
@@ -216,121 +230,145 @@ void transformSegments(std::vector<Segment> &segments, fTransform cbTransform) {
   }  // for
 };
 
+void transformSegments(std::vector<Segment> &segments, fTransform cbTransform) {
+  transformSegments(segments.data(), segments.size(), std::move(cbTransform));
+}  // transformSegments()
 
-// ===== Edge functionality =====
 
-/// @brief The _Edge class holds a horizontal pixel sequence for path boundaries and provides some useful static methods.
-class _Edge : public Point {
-public:
-  _Edge(int16_t _x, int16_t _y)
-    : Point(_x, _y), len(1) {};
-
-  uint16_t len;
-
-  /// @brief compare function for std::sort to sort points by (y) and ascending (x)
-  /// @param p1 first Edge-point
-  /// @param p2 second Edge-point
-  /// @return when p1 is lower than p2
-  static bool compare(const _Edge &p1, const _Edge &p2) {
-    if (p1.y != p2.y)
-      return (p1.y < p2.y);
-    if (p1.x != p2.x)
-      return (p1.x < p2.x);
-    return (p1.len < p2.len);
-  };
+// Calculate the conservative bounding box from the points, control points and radius values.
+BoundingBox boundingBox(const Segment *segments, size_t count) {
+  BoundingBox box;
+  int16_t startPosX = 0;
+  int16_t startPosY = 0;
+  int16_t posX = 0;
+  int16_t posY = 0;
 
-  /// @brief add another point or Edge to the Edge
-  /// @param p2
-  /// @return true when this Edge could be expanded.
-  bool expand(_Edge p2) {
-    if (y == p2.y) {
-      if (x > p2.x + p2.len) {
-        // no
-        return (false);
-      } else if (x + len < p2.x) {
-        // no
-        return (false);
+  for (size_t n = 0; n < count; n++) {
+    const Segment &pSeg = segments[n];
+    switch (pSeg.type) {
+      case Segment::Type::Move:
+        startPosX = posX = pSeg.x1;
+        startPosY = posY = pSeg.y1;
+        box.extend(posX, posY);
+        break;
 
-      } else {
-        // overlapping or joining edges
-        int16_t left = (x < p2.x ? x : p2.x);
-        int16_t right = (x + len > p2.x + p2.len ? x + len : p2.x + p2.len);
-        x = left;
-        len = right - left;
-        return (true);
-      }
+      case Segment::Type::Line:
+        posX = pSeg.x1;
+        posY = pSeg.y1;
+        box.extend(posX, posY);
+        break;
+
+      case Segment::Type::Curve:
+        // the curve is inside the convex hull of the control points.
+        box.extend(pSeg.p[0], pSeg.p[1]);
+        box.extend(pSeg.p[2], pSeg.p[3]);
+        posX = pSeg.p[4];
+        posY = pSeg.p[5];
+        box.extend(posX, posY);
+        break;
+
+      case Segment::Type::Arc:
+        if ((posX != pSeg.p[4]) || (posY != pSeg.p[5])) {
+          // the arc is inside the box of the ellipse, the radius may be enlarged by arcCenter.
+          int16_t rx = pSeg.p[0];
+          int16_t ry = pSeg.p[1];
+          int32_t cx256, cy256;
+          arcCenter(posX, posY, pSeg.p[4], pSeg.p[5], rx, ry, pSeg.p[2], pSeg.p[3], cx256, cy256);
+          box.extend(SCALE256(cx256), SCALE256(cy256), (abs(rx) > abs(ry) ? abs(rx) : abs(ry)) + 1);
+        }
+        posX = pSeg.p[4];
+        posY = pSeg.p[5];
+        box.extend(posX, posY);
+        break;
+
+      case Segment::Type::Circle:
+        box.extend(pSeg.p[0], pSeg.p[1], abs(pSeg.p[2]));
+        break;
+
+      case Segment::Type::Close:
+        posX = startPosX;
+        posY = startPosY;
+        break;
+
+      default:
+        break;
     }
-    return (false);
-  };
-};
+  }  // for
+  return (box);
+}  // boundingBox()
+
+
+BoundingBox boundingBox(const std::vector<Segment> &segments) {
+  return (boundingBox(segments.data(), segments.size()));
+}  // boundingBox()
+
 
+// ===== Edge functionality =====
+
+// Copy the edges of a closed sub-path to the output and mark local extreme sequences with a double-edge.
+// The marker edges are written in the same pass so the runtime is linear to the number of edges.
+void slopeEdges(const std::vector<_Edge> &pathEdges, std::vector<_Edge> &edges) {
+  size_t eSize = pathEdges.size();
+  if (eSize == 0) return;
+  GFXDRAW_STAT(edges, eSize);
+
+  if (eSize == 1) {
+    edges.push_back(pathEdges[0]);
+    return;
+  }
 
-// find local extreme sequences and mark them with a double-edge
-size_t slopeEdges(std::vector<_Edge> &edges, size_t start, size_t end) {
   int prevSlope;  // slope before any horizontal border points.
 
-  if (edges[end].y < edges[start].y) {
+  if (pathEdges[eSize - 1].y < pathEdges[0].y) {
     prevSlope = SLOPE_RAISING;
   } else {
     prevSlope = SLOPE_FALLING;
   }
 
-  _Edge *prevEdge = &edges[end];
-  int16_t prevY = edges[end].y;
+  const _Edge *prevEdge = &pathEdges[eSize - 1];
+  int16_t firstY = pathEdges[0].y;  // y of the first edge written to the output
+  bool isFirst = true;
 
-  size_t n = start;
-  while (n <= end) {
-    int16_t thisY = edges[n].y;
+  for (const _Edge &e : pathEdges) {
+    bool addMarker = false;
 
-    if (thisY > prevY) {
-      if (prevSlope == SLOPE_FALLING) {
-        // maximum extreme ends here: duplicate previous point
-        GFX_TRACE("  ins %d", n);
-        edges.insert(edges.begin() + n, *prevEdge);
-        edges[n].len = 0;
-        n++;
-        end++;
-        prevSlope = SLOPE_RAISING;
-      }
+    if (e.y > prevEdge->y) {
+      // maximum extreme ends here: duplicate previous point
+      addMarker = (prevSlope == SLOPE_FALLING);
+      prevSlope = SLOPE_RAISING;
 
-    } else if (thisY < prevY) {
-      if (prevSlope == SLOPE_RAISING) {
-        // minimum extreme ends here: duplicate previous point
-        GFX_TRACE("  ins %d", n);
-        edges.insert(edges.begin() + n, *prevEdge);
-        edges[n].len = 0;
-        n++;
-        end++;
-        prevSlope = SLOPE_FALLING;
-      }
+    } else if (e.y < prevEdge->y) {
+      // minimum extreme ends here: duplicate previous point
+      addMarker = (prevSlope == SLOPE_RAISING);
+      prevSlope = SLOPE_FALLING;
     }
 
-    prevEdge = &edges[n];
-    prevY = prevEdge->y;
-    n++;
-  }
+    int8_t dir = (prevSlope == SLOPE_RAISING) ? 1 : -1;
 
-  // last edge is extreme ?
-  if (edges[start].y > prevY) {
-    if (prevSlope == SLOPE_FALLING) {
-      // maximum extreme ends here: duplicate previous point
-      GFX_TRACE("  ins+ %d", n);
-      edges.insert(edges.begin() + n, *prevEdge);
-      edges[n].len = 0;
-      end++;
+    if (addMarker) {
+      GFX_TRACE("  ins %d/%d", prevEdge->x, prevEdge->y);
+      GFXDRAW_STAT(markerEdges, 1);
+      edges.push_back(*prevEdge);
+      edges.back().len = 0;
+      edges.back().dir = dir;
+      if (isFirst) firstY = prevEdge->y;
     }
 
-  } else if (edges[start].y < prevY) {
-    if (prevSlope == SLOPE_RAISING) {
-      // minimum extreme ends here: duplicate previous point
-      GFX_TRACE("  ins+ %d", n);
-      edges.insert(edges.begin() + n, *prevEdge);
-      edges[n].len = 0;
-      end++;
-    }
+    edges.push_back(e);
+    edges.back().dir = dir;
+    prevEdge = &e;
+    isFirst = false;
   }
 
-  return (end);
+  // last edge is extreme ?
+  if (((firstY > prevEdge->y) && (prevSlope == SLOPE_FALLING))
+      || ((firstY < prevEdge->y) && (prevSlope == SLOPE_RAISING))) {
+    GFX_TRACE("  ins+ %d/%d", prevEdge->x, prevEdge->y);
+    GFXDRAW_STAT(markerEdges, 1);
+    edges.push_back(*prevEdge);
+    edges.back().len = 0;
+    edges.back().dir = (prevSlope == SLOPE_RAISING) ? -1 : 1;
+  }
 }  // slopeEdges()
 
 
@@ -356,185 +394,105 @@ void dumpEdges(std::vector<_Edge> &edges) {
 /// @example pathText="M4 8l12-6l10 10h-8v4h-6z"
 std::vector<Segment> parsePath(const char *pathText) {
   GFX_TRACE("parsePath: '%s'", pathText);
-  char command = '-';
-
-  char *path = (char *)pathText;
-  int16_t lastX = 0, lastY = 0;
-
-  /// A lambda function to parse a numeric parameter from the inputText.
-  auto getNumParam = [&]() {
-    while (isspace(*path) || (*path == ',')) { path++; }
-    int16_t p = static_cast<int16_t>(strtol(path, &path, 10));
-    return (p);
-  };
-
-  /// A lambda function to parse a flag parameter from the inputText.
-  auto getBoolParam = [&]() {
-    while (isspace(*path) || (*path == ',')) { path++; }
-    bool flag = (*path++ == '1');
-    return (flag);
-  };
-
-  Segment Seg;
-  std::vector<Segment> vSeg;
 
-  while (path && *path) {
+  // count the segments first to allocate the vector at once.
+  std::vector<Segment> vSeg(_scanPath(pathText, nullptr, 0));
+  _scanPath(pathText, vSeg.data(), vSeg.size());
 
-    if (isspace(*path)) {
-      path++;
-
-    } else {
-      if (strchr("MmLlCcZHhVvAazO", *path))
-        command = *path++;
-
-      memset(&Seg, 0, sizeof(Seg));
-      bool f1, f2;  // flags
-
-      switch (command) {
-        case 'M':
-          Seg.type = Segment::Type::Move;
-          lastX = Seg.p[0] = getNumParam();
-          lastY = Seg.p[1] = getNumParam();
-          break;
+  // GFX_TRACE("  scanned: %d segments", vSeg.size());
+  // for (Segment &seg : vSeg) {
+  //   GFX_TRACE("  %04x - %d %d", seg.type, seg.p[0], seg.p[1]);
+  // }
 
-        case 'm':
-          // convert to absolute coordinates
-          Seg.type = Segment::Type::Move;
-          lastX = Seg.p[0] = lastX + getNumParam();
-          lastY = Seg.p[1] = lastY + getNumParam();
-          break;
+  return (vSeg);
+}
 
-        case 'L':
-          Seg.type = Segment::Type::Line;
-          lastX = Seg.p[0] = getNumParam();
-          lastY = Seg.p[1] = getNumParam();
-          break;
+// ===== Segment drawing functions =====
 
-        case 'l':
-          // convert to absolute coordinates
-          Seg.type = Segment::Type::Line;
-          lastX = Seg.p[0] = lastX + getNumParam();
-          lastY = Seg.p[1] = lastY + getNumParam();
-          break;
+// Draw a path (no fill).
+void drawSegments(const Segment *segments, size_t count, fSetPixel cbDraw) {
+  GFX_TRACE("drawSegments()");
+  GFXDRAW_STATS_SCOPE(statsScope);
+
+  const ClipRect clip = _clipRect;
+  _drawSegments(segments, count, [&](int16_t x, int16_t y) {
+    if (y >= POINT_INVALID_Y) {
+      cbDraw(x, y);
+    } else if (clip.contains(x, y)) {
+      GFXDRAW_STAT(borderPixels, 1);
+      cbDraw(x, y);
+    }
+  });
+}  // drawSegments()
 
-        case 'C':
-          // curve defined with absolute points - no convertion required
-          Seg.type = Segment::Type::Curve;
-          Seg.p[0] = getNumParam();
-          Seg.p[1] = getNumParam();
-          Seg.p[2] = getNumParam();
-          Seg.p[3] = getNumParam();
-          lastX = Seg.p[4] = getNumParam();
-          lastY = Seg.p[5] = getNumParam();
-          break;
 
-        case 'c':
-          // curve defined with relative points - convert to absolute coordinates
-          Seg.type = Segment::Type::Curve;
-          Seg.p[0] = lastX + getNumParam();
-          Seg.p[1] = lastY + getNumParam();
-          Seg.p[2] = lastX + getNumParam();
-          Seg.p[3] = lastY + getNumParam();
-          lastX = Seg.p[4] = lastX + getNumParam();
-          lastY = Seg.p[5] = lastY + getNumParam();
-          break;
+void drawSegments(std::vector<Segment> &segments, fSetPixel cbDraw) {
+  drawSegments(segments.data(), segments.size(), std::move(cbDraw));
+}  // drawSegments()
 
-        case 'H':
-          // Horizontal line with absolute horizontal end point coordinate - convert to absolute line
-          Seg.type = Segment::Type::Line;
-          lastX = Seg.p[0] = getNumParam();
-          Seg.p[1] = lastY;  // stay;
-          break;
 
-        case 'h':
-          // Horizontal line with relative horizontal end-point coordinate - convert to absolute line
-          Seg.type = Segment::Type::Line;
-          lastX = Seg.p[0] = lastX + getNumParam();
-          Seg.p[1] = lastY;  // stay;
-          break;
+// Draw a path with a stroke width by filling the outline of the stroke.
+void drawSegments(const Segment *segments, size_t count, int16_t width, fDrawSpan cbDraw, StrokeFlags flags) {
+  GFX_TRACE("drawSegments(width=%d)", width);
+  GFXDRAW_STATS_SCOPE(statsScope);
 
-        case 'V':
-          // Vertical line with absolute vertical end point coordinate - convert to absolute line
-          Seg.type = Segment::Type::Line;
-          Seg.p[0] = lastX;  // stay;
-          lastY = Seg.p[1] = getNumParam();
-          break;
+  if (width <= 1) {
+    const ClipRect clip = _clipRect;
+    _drawSegments(segments, count, [&](int16_t x, int16_t y) {
+      if ((y != POINT_BREAK_Y) && (clip.contains(x, y))) {
+        GFXDRAW_STAT(borderPixels, 1);
+        cbDraw(x, x, y);
+      }
+    });
 
-        case 'v':
-          // Vertical line with relative horizontal end-point coordinate - convert to absolute line
-          Seg.type = Segment::Type::Line;
-          Seg.p[0] = lastX;  // stay;
-          lastY = Seg.p[1] = lastY + getNumParam();
-          break;
+  } else {
+    GFXDRAW_STAT(segments, count);
+    _EdgeTable table(segments, count, width, flags);
+    while (table.nextLine()) {
+      for (const _Span &s : table.spans) {
+        GFXDRAW_STAT(borderPixels, s.x1 - s.x0 + 1);
+        cbDraw(s.x0, s.x1, table.y);
+      }
+    }
+  }
+}  // drawSegments()
 
-        case 'A':
-          // Ellipsis arc with absolute end-point coordinates.
-          Seg.type = Segment::Type::Arc;
-          Seg.p[0] = getNumParam();  // rx
-          Seg.p[1] = getNumParam();  // ry
-          Seg.p[2] = getNumParam();  // rotation
-          f1 = getBoolParam();
-          f2 = getBoolParam();
-          Seg.p[3] = (f1 ? 0x01 : 0x00) + (f2 ? 0x02 : 0x00);  // flags
-          lastX = Seg.p[4] = getNumParam();
-          lastY = Seg.p[5] = getNumParam();
-          break;
 
-        case 'a':
-          // Ellipsis arc with relative end-point coordinates.
-          Seg.type = Segment::Type::Arc;
-          Seg.p[0] = getNumParam();  // rx
-          Seg.p[1] = getNumParam();  // ry
-          Seg.p[2] = getNumParam();  // rotation
-          f1 = getBoolParam();
-          f2 = getBoolParam();
-          Seg.p[3] = (f1 ? 0x01 : 0x00) + (f2 ? 0x02 : 0x00);  // flags
-          lastX = Seg.p[4] = lastX + getNumParam();
-          lastY = Seg.p[5] = lastY + getNumParam();
-          break;
+void drawSegments(const Segment *segments, size_t count, int16_t width, fSetPixel cbDraw, StrokeFlags flags) {
+  drawSegments(
+    segments, count, width,
+    [&](int16_t x0, int16_t x1, int16_t y) {
+      while (x0 <= x1) cbDraw(x0++, y);
+    },
+    flags);
+}  // drawSegments()
 
-        case 'z':
-        case 'Z':
-          Seg.type = Segment::Type::Close;
-          break;
 
-          // non svg path types:
-        case 'O':
-          // Draw a whole circle by center and radius
-          Seg.type = Segment::Type::Circle;
-          Seg.p[0] = getNumParam();  // Center.x
-          Seg.p[1] = getNumParam();  // Center.y
-          Seg.p[2] = getNumParam();  // radius
-          lastX = lastY = 0;
-          break;
-      }
-      vSeg.push_back(Seg);
-      // } else { GFX_TRACE("unknown segment '%c'", *path);
-    }
-  }
+void drawSegments(std::vector<Segment> &segments, int16_t width, fDrawSpan cbDraw, StrokeFlags flags) {
+  drawSegments(segments.data(), segments.size(), width, std::move(cbDraw), flags);
+}  // drawSegments()
 
-  // GFX_TRACE("  scanned: %d segments", vSeg.size());
-  // for (Segment &seg : vSeg) {
-  //   GFX_TRACE("  %04x - %d %d", seg.type, seg.p[0], seg.p[1]);
-  // }
 
-  return (vSeg);
-}
+void drawSegments(std::vector<Segment> &segments, int16_t width, fSetPixel cbDraw, StrokeFlags flags) {
+  drawSegments(segments.data(), segments.size(), width, std::move(cbDraw), flags);
+}  // drawSegments()
 
-// ===== Segment drawing functions =====
 
-// Draw a path (no fill).
-void drawSegments(std::vector<Segment> &segments, fSetPixel cbDraw) {
-  GFX_TRACE("drawSegments()");
+// Draw the pixels of a path including the sub-path breaks.
+void _drawSegments(const Segment *segments, size_t count, fSetPixel cbDraw) {
   int16_t startPosX = 0;
   int16_t startPosY = 0;
   int16_t posX = 0;
   int16_t posY = 0;
   int16_t endPosX = 0;
   int16_t endPosY = 0;
+  PixelStreamFilter filter;
+
+  GFXDRAW_STAT(segments, count);
 
-  if (segments.size()) {
-    for (Segment &pSeg : segments) {
+  if (count) {
+    for (size_t n = 0; n < count; n++) {
+      const Segment &pSeg = segments[n];
       switch (pSeg.type) {
         case Segment::Type::Move:
           startPosX = endPosX = pSeg.x1;
@@ -544,7 +502,7 @@ void drawSegments(std::vector<Segment> &segments, fSetPixel cbDraw) {
         case Segment::Type::Line:
           endPosX = pSeg.x1;
           endPosY = pSeg.y1;
-          gfxDraw::drawLine(posX, posY, endPosX, endPosY, cbDraw);
+          gfxDraw::_drawLine(posX, posY, endPosX, endPosY, cbDraw);
           break;
 
         case Segment::Type::Curve:
@@ -554,7 +512,7 @@ void drawSegments(std::vector<Segment> &segments, fSetPixel cbDraw) {
             posX, posY,
             pSeg.p[0], pSeg.p[1],
             pSeg.p[2], pSeg.p[3],
-            endPosX, endPosY, cbDraw);
+            endPosX, endPosY, cbDraw, filter);
           break;
 
         case Segment::Type::Arc:
@@ -565,7 +523,7 @@ void drawSegments(std::vector<Segment> &segments, fSetPixel cbDraw) {
                            pSeg.p[0], pSeg.p[1],  // x & y radius
                            pSeg.p[2],             // phi, ellipsis rotation
                            pSeg.p[3],             // flags
-                           cbDraw);
+                           cbDraw, filter);
           break;
 
         case Segment::Type::Circle:
@@ -583,7 +541,7 @@ void drawSegments(std::vector<Segment> &segments, fSetPixel cbDraw) {
           endPosX = startPosX;
           endPosY = startPosY;
           if ((posX != endPosX) || (posY != endPosY)) {
-            gfxDraw::drawLine(posX, posY, endPosX, endPosY, cbDraw);
+            gfxDraw::_drawLine(posX, posY, endPosX, endPosY, cbDraw);
           }
           cbDraw(0, POINT_BREAK_Y);
           break;
@@ -598,118 +556,596 @@ void drawSegments(std::vector<Segment> &segments, fSetPixel cbDraw) {
     }  // for
     cbDraw(0, POINT_BREAK_Y);
   }
-}  // drawSegments()
+}  // _drawSegments()
+
+
+// Trace the path and collect all edges sorted by lines (y) and ascending (x) for the scanline fill.
+void _collectEdges(const Segment *segments, size_t count, std::vector<_Edge> &edges) {
+  GFX_TRACE("_collectEdges()");
+  std::vector<_Edge> pathEdges;  // edges of the current sub-path
+
+  // dumpSegments(segments);
+
+  // create the path and collect edges, sub-paths are separated by (0/POINT_BREAK_Y) points
+  _drawSegments(segments, count,
+                [&](int16_t x, int16_t y) {
+                  //  GFX_TRACE("    P(%d/%d)", x, y);
+                  if (y == POINT_BREAK_Y) {
+                    if ((pathEdges.size() > 1) && (pathEdges.front().expand(pathEdges.back()))) {
+                      // last point is in first edge
+                      pathEdges.pop_back();
+                    }
+
+                    // Normalize (*2) sub-path for fill algorithm.
+                    slopeEdges(pathEdges, edges);
+                    pathEdges.clear();
+
+                  } else if ((!pathEdges.empty()) && (pathEdges.back().expand(_Edge(x, y)))) {
+                    // fine
+                  } else {
+                    // first in sequence on on new line.
+                    pathEdges.push_back(_Edge(x, y));
+                  }
+                });
+  slopeEdges(pathEdges, edges);
+  // dumpEdges(edges);
+
+  // sort edges by ascending lines (y)
+  GFX_TRACE(" ... sort");
+  GFXDRAW_STAT(sortSize, edges.size());
+  std::sort(edges.begin(), edges.end(), _Edge::compare);
+  // dumpEdges(edges);
+}  // _collectEdges()
 
 
 /// @brief Draw a path with filling.
-void fillSegments(std::vector<Segment> &segments, fSetPixel cbBorder, fSetPixel cbFill) {
+void fillSegments(const Segment *segments, size_t count, fSetPixel cbBorder, fSetPixel cbFill, FillFlags flags) {
   GFX_TRACE("fillSegments()");
-  std::vector<_Edge> edges;
-  _Edge *lastEdge = nullptr;
+  fillSegments<fSetPixel &, fSetPixel &>(segments, count, cbBorder, cbFill, flags);
+}  // fillSegments()
 
-  size_t n;
-  fSetPixel cbStroke = cbBorder ? cbBorder : cbFill;  // use cbFill when no cbBorder is given.
+void fillSegments(std::vector<Segment> &segments, fSetPixel cbBorder, fSetPixel cbFill, FillFlags flags) {
+  fillSegments(segments.data(), segments.size(), std::move(cbBorder), std::move(cbFill), flags);
+}  // fillSegments()
 
-  // dumpSegments(segments);
 
-  // create the path and collect edges
-  drawSegments(segments,
-               [&](int16_t x, int16_t y) {
-                 //  GFX_TRACE("    P(%d/%d)", x, y);
-                 if ((lastEdge) && (lastEdge->expand(_Edge(x, y)))) {
-                   // fine
-                 } else {
-                   // first in sequence on on new line.
-                   edges.push_back(_Edge(x, y));
-                   lastEdge = &edges.back();
-                 }
-               });
-  // dumpEdges(edges);
+/// @brief Draw a path with filling using spans for the inner pixels.
+void fillSegments(const Segment *segments, size_t count, fSetPixel cbBorder, fDrawSpan cbFill, FillFlags flags) {
+  GFX_TRACE("fillSegments()");
+  fillSegments<fSetPixel &, fDrawSpan &>(segments, count, cbBorder, cbFill, flags);
+}  // fillSegments()
 
-  // sub-paths are separated by (0/POINT_BREAK_Y) points;
-  size_t eSize = edges.size();
+void fillSegments(std::vector<Segment> &segments, fSetPixel cbBorder, fDrawSpan cbFill, FillFlags flags) {
+  fillSegments(segments.data(), segments.size(), std::move(cbBorder), std::move(cbFill), flags);
+}  // fillSegments()
 
-  size_t eStart = 0;
-  n = eStart;
-  while (n < eSize) {
-    if (edges[n].y != POINT_BREAK_Y) {
-      // mark the end of the path or sub-path
-      n++;
-    } else {
-      if (eStart < n - 1) {
 
-        // Normalize (*2) sub-path for fill algorithm.
-        // GFX_TRACE("  sub-paths %d ... %d", eStart, n - 1);
+// ===== Active edge table functionality =====
 
-        if (edges[eStart].expand(edges[n - 1])) {
-          // last point is in first edge
-          edges.erase(edges.begin() + n - 1);
-          GFX_TRACE("  del %d", n - 1);
-          n--;
-        }
-        // dumpEdges(edges);
+// Flatten the segments into the outline of a stroke.
+_EdgeTable::_EdgeTable(const Segment *segments, size_t count, int16_t width, StrokeFlags flags) {
+  GFX_TRACE("_EdgeTable(width=%d)", width);
+  _clip = _clipRect;
+  _halfWidth = 128 * (int32_t)width;
+  _strokeFlags = flags;
+  if (_halfWidth > 0) _addSegments(segments, count);
+  _sortEdges();
+}  // _EdgeTable()
+
+
+// Add the outline of the stroke for all segments using the same segment walk as drawSegments.
+// The sub-paths are not closed automatically.
+void _EdgeTable::_addSegments(const Segment *segments, size_t count) {
+  int16_t startPosX = 0;
+  int16_t startPosY = 0;
+  int16_t posX = 0;
+  int16_t posY = 0;
+  int16_t endPosX = 0;
+  int16_t endPosY = 0;
+
+  for (size_t n = 0; n < count; n++) {
+    const Segment &pSeg = segments[n];
+    switch (pSeg.type) {
+      case Segment::Type::Move:
+        _strokeEnd(false);
+        startPosX = endPosX = pSeg.x1;
+        startPosY = endPosY = pSeg.y1;
+        break;
+
+      case Segment::Type::Line:
+        endPosX = pSeg.x1;
+        endPosY = pSeg.y1;
+        _addLine(256 * posX, 256 * posY, 256 * endPosX, 256 * endPosY);
+        break;
+
+      case Segment::Type::Curve:
+        endPosX = pSeg.p[4];
+        endPosY = pSeg.p[5];
+        _addCurve(posX, posY, pSeg.p[0], pSeg.p[1], pSeg.p[2], pSeg.p[3], endPosX, endPosY);
+        break;
 
-        n = slopeEdges(edges, eStart, n - 1) + 1;
-        // dumpEdges(edges);
+      case Segment::Type::Arc:
+        endPosX = pSeg.p[4];
+        endPosY = pSeg.p[5];
+        _addArc(posX, posY, endPosX, endPosY, pSeg.p[0], pSeg.p[1], pSeg.p[2], pSeg.p[3]);
+        break;
 
-        GFX_TRACE("  sub-paths %d ... %d", eStart, n - 1);
+      case Segment::Type::Circle:
+        _strokeEnd(false);
+        _addCircle(pSeg.p[0], pSeg.p[1], pSeg.p[2]);
+        _strokeEnd(true);
+        break;
 
-      }  // if
+      case Segment::Type::Close:
+        endPosX = startPosX;
+        endPosY = startPosY;
+        _addLine(256 * posX, 256 * posY, 256 * endPosX, 256 * endPosY);
+        _strokeEnd(true);
+        break;
 
-      n = eStart = n + 1;
-      eSize = edges.size();
+      default:
+        GFX_TRACE("unknown segment-%04x", pSeg.type);
+        break;
+    }
+
+    posX = endPosX;
+    posY = endPosY;
+  }  // for
+
+  _strokeEnd(false);
+}  // _addSegments()
+
+
+// Sort the edges and prepare for the first line.
+void _EdgeTable::_sortEdges() {
+  std::sort(_edges.begin(), _edges.end(), [](const _LineEdge &e1, const _LineEdge &e2) {
+    return (e1.firstLine < e2.firstLine);
+  });
+
+  if (!_edges.empty()) {
+    firstLine = _edges[0].firstLine;
+    for (_LineEdge &e : _edges) {
+      if (e.lastLine > lastLine) lastLine = e.lastLine;
     }
   }
 
-  // sort edges by ascending lines (y)
-  GFX_TRACE(" ... sort");
-  std::sort(edges.begin(), edges.end(), _Edge::compare);
-  // dumpEdges(edges);
+  // skip the lines outside the clip rectangle
+  if (firstLine < _clip.y0) firstLine = _clip.y0;
+  if (lastLine > _clip.y1) lastLine = _clip.y1;
+  setLines(firstLine, lastLine);
+}  // _sortEdges()
+
 
-  GFX_TRACE(" ...a");
+// Add a line of the flattened path to the points of the current sub-path, coordinates in 1/256 pixel units.
+void _EdgeTable::_addLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+  if (_polyline.empty()) _polyline.push_back({ x0, y0 });
+  if ((_polyline.back().x != x1) || (_polyline.back().y != y1)) _polyline.push_back({ x1, y1 });
+}  // _addLine()
+
+
+// Add a line edge, coordinates in 1/256 pixel units.
+void _EdgeTable::_addEdge(int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+  _LineEdge e;
+  if (y0 < y1) {
+    e = { x0, y0, x1, y1, 0, 0, 1 };
+  } else {
+    e = { x1, y1, x0, y0, 0, 0, -1 };
+  }
 
-  int16_t y = INT16_MAX;
-  int16_t x = INT16_MAX;
+  // the edge is crossing the centers of the lines y0 <= y < y1, the lower end is excluded.
+  e.firstLine = (e.y0 + 255) >> 8;
+  e.lastLine = ((e.y1 + 255) >> 8) - 1;
+  if (e.firstLine <= e.lastLine) _edges.push_back(e);
+}  // _addEdge()
 
-  bool isInside = false;
 
-  // Draw borderpoints and lines on inner segments
-  for (_Edge &p : edges) {
+// ===== stroke outlines =====
 
-    // if (p.y == 38) {
-    //   GFX_TRACE("  P %d/%d-%d", p.x, p.y, p.len);
-    // };
+// Add a closed polygon with the edges in the direction of a positive area.
+// All polygons of a stroke are added with the same orientation so the NonZero rule fills the union of them.
+void _EdgeTable::_addPolygon(const _Point256 *points, size_t count) {
+  int64_t area = 0;
+  for (size_t n = 0; n < count; n++) {
+    const _Point256 &p0 = points[n];
+    const _Point256 &p1 = points[(n + 1) % count];
+    area += ((int64_t)p0.x * p1.y) - ((int64_t)p1.x * p0.y);
+  }
 
-    if (p.y != y) {
-      // start a new line
-      isInside = false;
-      y = p.y;
+  if (area > 0) {
+    for (size_t n = 0; n < count; n++) {
+      const _Point256 &p0 = points[n];
+      const _Point256 &p1 = points[(n + 1) % count];
+      _addEdge(p0.x, p0.y, p1.x, p1.y);
+    }
+  } else if (area < 0) {
+    for (size_t n = 0; n < count; n++) {
+      const _Point256 &p0 = points[(n + 1) % count];
+      const _Point256 &p1 = points[n];
+      _addEdge(p0.x, p0.y, p1.x, p1.y);
+    }
+  }
+}  // _addPolygon()
+
+
+// Add a filled circle for round caps and joins, coordinates in 1/256 pixel units.
+void _EdgeTable::_addDisc(int32_t cx, int32_t cy, int32_t radius) {
+  // number of lines for a max. 1/4 pixel distance of the lines to the circle.
+  int32_t n = 4 * (int32_t)isqrt(2 * (uint64_t)((radius >> 8) + 1)) + 4;
+
+  int32_t lastX = cx + radius;
+  int32_t lastY = cy;
+  for (int32_t k = 1; k <= n; k++) {
+    int32_t s, c;
+    sinCos65536((int32_t)(((int64_t)DEGREE65536(360) * k) / n), s, c);
+    int32_t nextX = cx + (int32_t)(((int64_t)radius * c + 32768) >> 16);
+    int32_t nextY = cy + (int32_t)(((int64_t)radius * s + 32768) >> 16);
+    if (k == n) {
+      nextX = cx + radius;
+      nextY = cy;
     }
+    _addEdge(lastX, lastY, nextX, nextY);
+    lastX = nextX;
+    lastY = nextY;
+  }
+}  // _addDisc()
 
-    if (y == POINT_BREAK_Y) continue;
 
-    if (p.len == 0) {
-      // don't draw, it is just an marker for a extreme sequence.
+// Convert the points of the current sub-path into polygons for the lines, joins and caps.
+void _EdgeTable::_strokeEnd(bool closed) {
+  std::vector<_Point256> &pts = _polyline;
+  const int32_t hw = _halfWidth;
 
-    } else {
-      // draw the border
-      for (uint16_t l = 0; l < p.len; l++) {
-        cbStroke(p.x + l, y);
+  if (closed && (pts.size() > 1) && (pts.front().x == pts.back().x) && (pts.front().y == pts.back().y)) {
+    pts.pop_back();
+  }
+  size_t count = pts.size();
+
+  if (count == 1) {
+    // a sub-path without length only has caps.
+    const _Point256 &p = pts[0];
+    if (_strokeFlags & StrokeFlags::RoundCap) {
+      _addDisc(p.x, p.y, hw);
+    } else if (_strokeFlags & StrokeFlags::SquareCap) {
+      _Point256 square[4] = { { p.x - hw, p.y - hw }, { p.x + hw, p.y - hw }, { p.x + hw, p.y + hw }, { p.x - hw, p.y + hw } };
+      _addPolygon(square, 4);
+    }
+  }
+
+  if (count < 2) {
+    pts.clear();
+    return;
+  }
+  if (count == 2) closed = false;
+
+  // direction of the line from point n to the next point as unit vector in 1/16384 units.
+  auto unit = [&](size_t n, int32_t &ux, int32_t &uy) {
+    const _Point256 &p0 = pts[n];
+    const _Point256 &p1 = pts[(n + 1) % count];
+    int64_t dx = p1.x - p0.x;
+    int64_t dy = p1.y - p0.y;
+    int64_t len = isqrt((uint64_t)(dx * dx + dy * dy));
+    ux = (int32_t)((dx * 16384) / len);
+    uy = (int32_t)((dy * 16384) / len);
+  };
+
+  // the lines
+  size_t lines = closed ? count : count - 1;
+  for (size_t n = 0; n < lines; n++) {
+    int32_t ux, uy;
+    unit(n, ux, uy);
+    int32_t nx = (int32_t)(((int64_t)-uy * hw) >> 14);
+    int32_t ny = (int32_t)(((int64_t)ux * hw) >> 14);
+    const _Point256 &p0 = pts[n];
+    const _Point256 &p1 = pts[(n + 1) % count];
+    _Point256 quad[4] = { { p0.x + nx, p0.y + ny }, { p1.x + nx, p1.y + ny }, { p1.x - nx, p1.y - ny }, { p0.x - nx, p0.y - ny } };
+    _addPolygon(quad, 4);
+  }
+
+  // the joins
+  for (size_t n = (closed ? 0 : 1); n < (closed ? count : count - 1); n++) {
+    const _Point256 &v = pts[n];
+    int32_t u1x, u1y, u2x, u2y;
+    unit((n + count - 1) % count, u1x, u1y);
+    unit(n, u2x, u2y);
+
+    int64_t cross = ((int64_t)u1x * u2y) - ((int64_t)u1y * u2x);  // sin of the turn in 1/2^28 units
+    if (cross == 0) {
+      // a turn back by 180 degree is joined by a circle. The bevel and miter join are the ends of the lines.
+      int64_t dot = ((int64_t)u1x * u2x) + ((int64_t)u1y * u2y);
+      if ((dot < 0) && (_strokeFlags & StrokeFlags::RoundJoin)) _addDisc(v.x, v.y, hw);
+      continue;
+    }
+
+    // unit normals on the outer side of the turn
+    int32_t side = (cross > 0) ? -1 : 1;
+    int32_t n1x = -side * u1y, n1y = side * u1x;
+    int32_t n2x = -side * u2y, n2y = side * u2x;
+    _Point256 o1 = { v.x + (int32_t)(((int64_t)n1x * hw) >> 14), v.y + (int32_t)(((int64_t)n1y * hw) >> 14) };
+    _Point256 o2 = { v.x + (int32_t)(((int64_t)n2x * hw) >> 14), v.y + (int32_t)(((int64_t)n2y * hw) >> 14) };
+
+    // the bisector of the normals has a length of 2 * cos(turn / 2).
+    // The miter length from the inner to the outer corner is width / cos(turn / 2) like in SVG.
+    int64_t bx = n1x + n2x;
+    int64_t by = n1y + n2y;
+    int64_t b2 = (bx * bx) + (by * by);
+
+    if (_strokeFlags & StrokeFlags::RoundJoin) {
+      // small turns with a bevel closer than 1/4 pixel to the circle are joined by a bevel.
+      int64_t sin2 = (cross >> 14) * (cross >> 14);
+      if ((b2 > ((int64_t)1 << 28)) && (sin2 * hw < ((int64_t)1 << 37))) {
+        _Point256 bevel[3] = { v, o1, o2 };
+        _addPolygon(bevel, 3);
+      } else {
+        _addDisc(v.x, v.y, hw);
       }
+
+    } else if ((!(_strokeFlags & StrokeFlags::BevelJoin)) && (b2 * MITER_LIMIT * MITER_LIMIT >= ((int64_t)1 << 30))) {
+      // miter length <= MITER_LIMIT * width: cos(turn / 2) >= 1 / MITER_LIMIT
+      _Point256 miter = { v.x + (int32_t)((bx * 2 * hw * 16384) / b2), v.y + (int32_t)((by * 2 * hw * 16384) / b2) };
+      _Point256 join[4] = { v, o1, miter, o2 };
+      _addPolygon(join, 4);
+
+    } else {
+      _Point256 bevel[3] = { v, o1, o2 };
+      _addPolygon(bevel, 3);
     }
+  }
+
+  // the caps
+  if (!closed) {
+    for (int16_t end = 0; end < 2; end++) {
+      int32_t ux, uy;
+      unit(end ? count - 2 : 0, ux, uy);
+      const _Point256 &p = pts[end ? count - 1 : 0];
+      if (end == 0) {
+        ux = -ux;
+        uy = -uy;
+      }
+
+      if (_strokeFlags & StrokeFlags::RoundCap) {
+        _addDisc(p.x, p.y, hw);
 
-    // draw the fill
-    if (isInside) {
-      while (x < p.x) {
-        cbFill(x++, y);
+      } else if (_strokeFlags & StrokeFlags::SquareCap) {
+        int32_t dx = (int32_t)(((int64_t)ux * hw) >> 14);
+        int32_t dy = (int32_t)(((int64_t)uy * hw) >> 14);
+        _Point256 cap[4] = { { p.x - dy, p.y + dx }, { p.x - dy + dx, p.y + dx + dy }, { p.x + dy + dx, p.y - dx + dy }, { p.x + dy, p.y - dx } };
+        _addPolygon(cap, 4);
       }
     }
-    isInside = (!isInside);
-    // if (p.x + p.len > x)
-    x = p.x + p.len;
   }
-}
+  pts.clear();
+}  // _strokeEnd()
+
+
+// Add a cubic bezier curve by flattening into lines.
+void _EdgeTable::_addCurve(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3) {
+  // The distance of the flattened lines to the curve is below 3/4 * d / (n*n) pixels,
+  // where d is the maximum second difference of the control points.
+  int32_t d = std::max(abs(x0 - 2 * x1 + x2) + abs(y0 - 2 * y1 + y2), abs(x1 - 2 * x2 + x3) + abs(y1 - 2 * y2 + y3));
+  int64_t n = std::min((int32_t)isqrt(3 * d) + 1, (int32_t)256);  // max 1/4 pixel distance
+  int64_t n3 = n * n * n;
+
+  int32_t lastX = 256 * x0;
+  int32_t lastY = 256 * y0;
+
+  for (int64_t k = 1; k <= n; k++) {
+    int64_t s = n - k;
+    int64_t b0 = s * s * s;
+    int64_t b1 = 3 * s * s * k;
+    int64_t b2 = 3 * s * k * k;
+    int64_t b3 = k * k * k;
+    int32_t nextX = (int32_t)(256 * (b0 * x0 + b1 * x1 + b2 * x2 + b3 * x3) / n3);
+    int32_t nextY = (int32_t)(256 * (b0 * y0 + b1 * y1 + b2 * y2 + b3 * y3) / n3);
+    _addLine(lastX, lastY, nextX, nextY);
+    lastX = nextX;
+    lastY = nextY;
+  }
+}  // _addCurve()
+
+
+#ifdef GFXDRAW_NO_FLOAT
+// Number of lines for an arc with a max. 1/4 pixel distance of the lines to the arc.
+// The step angle 2 * acos(1 - 0.25 / r) is approximated by sqrt(2 / r) for r > 1.
+static int32_t _arcSteps(int32_t r, int32_t sweep) {
+  int64_t n;
+  if (r > 1) {
+    // sweep in radians * sqrt(r / 2), 1144 = 65536 * PI / 180
+    n = (((int64_t)sweep * isqrt((uint64_t)r * 32768) * 1144) + ((int64_t)1 << 40) - 1) >> 40;
+  } else {
+    n = (sweep + DEGREE65536(90) - 1) / DEGREE65536(90);
+  }
+  return (n < 1 ? 1 : (int32_t)n);
+}  // _arcSteps()
+#endif
+
+
+// Add an arc by flattening into lines using the same center and direction as drawArc.
+void _EdgeTable::_addArc(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t rx, int16_t ry, int16_t phi, int16_t flags) {
+  if ((x1 == x2) && (y1 == y2)) return;
+
+  int32_t cx256, cy256;
+  arcCenter(x1, y1, x2, y2, rx, ry, phi, flags, cx256, cy256);
+
+  if ((rx <= 0) || (ry <= 0)) {
+    _addLine(256 * x1, 256 * y1, 256 * x2, 256 * y2);
+    return;
+  }
+
+  if (rx == ry) {
+    // drawArc uses a circle around the rounded center
+    cx256 = 256 * SCALE256(cx256);
+    cy256 = 256 * SCALE256(cy256);
+  }
+
+#ifdef GFXDRAW_NO_FLOAT
+  // the angles on the ellipse are calculated in 1/65536 degree on the unrotated ellipse.
+  int32_t sinphi, cosphi;
+  sinCos65536(DEGREE65536(phi), sinphi, cosphi);
+
+  int64_t u1 = 256 * x1 - cx256, v1 = 256 * y1 - cy256;
+  int64_t u2 = 256 * x2 - cx256, v2 = 256 * y2 - cy256;
+  int32_t startAngle = atan2_65536((-sinphi * u1 + cosphi * v1) * rx, (cosphi * u1 + sinphi * v1) * ry);
+  int32_t endAngle = atan2_65536((-sinphi * u2 + cosphi * v2) * rx, (cosphi * u2 + sinphi * v2) * ry);
+  int32_t sweep = endAngle - startAngle;
 
+  if (flags & ArcFlags::Clockwise) {
+    if (sweep <= 0) sweep += DEGREE65536(360);
+  } else {
+    if (sweep >= 0) sweep -= DEGREE65536(360);
+  }
+
+  int32_t n = _arcSteps(rx > ry ? rx : ry, sweep < 0 ? -sweep : sweep);
+
+  int32_t lastX = 256 * x1;
+  int32_t lastY = 256 * y1;
+
+  for (int32_t k = 1; k < n; k++) {
+    int32_t s, c;
+    sinCos65536(startAngle + (int32_t)(((int64_t)sweep * k) / n), s, c);
+    int64_t ex = (int64_t)rx * c;
+    int64_t ey = (int64_t)ry * s;
+    int32_t nextX = cx256 + (int32_t)(((ex * cosphi) - (ey * sinphi) + (1 << 23)) >> 24);
+    int32_t nextY = cy256 + (int32_t)(((ex * sinphi) + (ey * cosphi) + (1 << 23)) >> 24);
+    _addLine(lastX, lastY, nextX, nextY);
+    lastX = nextX;
+    lastY = nextY;
+  }
+
+#else
+  // the angles on the ellipse are calculated on the unrotated ellipse.
+  double sinphi = sin(phi * M_PI / 180);
+  double cosphi = cos(phi * M_PI / 180);
+
+  double u1 = 256.0 * x1 - cx256, v1 = 256.0 * y1 - cy256;
+  double u2 = 256.0 * x2 - cx256, v2 = 256.0 * y2 - cy256;
+  double startAngle = atan2((-sinphi * u1 + cosphi * v1) / ry, (cosphi * u1 + sinphi * v1) / rx);
+  double endAngle = atan2((-sinphi * u2 + cosphi * v2) / ry, (cosphi * u2 + sinphi * v2) / rx);
+  double sweep = endAngle - startAngle;
+
+  if (flags & ArcFlags::Clockwise) {
+    if (sweep <= 0) sweep += 2 * M_PI;
+  } else {
+    if (sweep >= 0) sweep -= 2 * M_PI;
+  }
+
+  // step angle for a max. 1/4 pixel distance of the lines to the arc
+  double r = (rx > ry ? rx : ry);
+  double step = (r > 1) ? 2 * acos(1 - 0.25 / r) : (M_PI / 2);
+  int32_t n = (int32_t)ceil(fabs(sweep) / step);
+
+  int32_t lastX = 256 * x1;
+  int32_t lastY = 256 * y1;
+
+  for (int32_t k = 1; k < n; k++) {
+    double a = startAngle + (sweep * k) / n;
+    double ex = 256.0 * rx * cos(a);
+    double ey = 256.0 * ry * sin(a);
+    int32_t nextX = cx256 + std::lround((ex * cosphi) - (ey * sinphi));
+    int32_t nextY = cy256 + std::lround((ex * sinphi) + (ey * cosphi));
+    _addLine(lastX, lastY, nextX, nextY);
+    lastX = nextX;
+    lastY = nextY;
+  }
+#endif
+  _addLine(lastX, lastY, 256 * x2, 256 * y2);
+}  // _addArc()
+
+
+// Add a full circle as a closed sub-path by flattening into lines.
+void _EdgeTable::_addCircle(int16_t cx, int16_t cy, int16_t radius) {
+  if (radius <= 0) return;
+
+#ifdef GFXDRAW_NO_FLOAT
+  int32_t n = _arcSteps(radius, DEGREE65536(360));
+#else
+  double step = (radius > 1) ? 2 * acos(1 - 0.25 / radius) : (M_PI / 2);
+  int32_t n = (int32_t)ceil(2 * M_PI / step);
+#endif
+
+  int32_t lastX = 256 * (cx + radius);
+  int32_t lastY = 256 * cy;
+
+  for (int32_t k = 1; k <= n; k++) {
+#ifdef GFXDRAW_NO_FLOAT
+    int32_t s, c;
+    sinCos65536((int32_t)(((int64_t)DEGREE65536(360) * k) / n), s, c);
+    int32_t nextX = 256 * cx + (int32_t)(((int64_t)radius * c + 128) >> 8);
+    int32_t nextY = 256 * cy + (int32_t)(((int64_t)radius * s + 128) >> 8);
+#else
+    double a = (2 * M_PI * k) / n;
+    int32_t nextX = 256 * cx + std::lround(256.0 * radius * cos(a));
+    int32_t nextY = 256 * cy + std::lround(256.0 * radius * sin(a));
+#endif
+    if (k == n) {
+      nextX = 256 * (cx + radius);
+      nextY = 256 * cy;
+    }
+    _addLine(lastX, lastY, nextX, nextY);
+    lastX = nextX;
+    lastY = nextY;
+  }
+}  // _addCircle()
+
+
+// Restrict the calculation to a range of lines.
+void _EdgeTable::setLines(int32_t first, int32_t last) {
+  _active.clear();
+  _nextEdge = 0;
+  _line = first - 1;
+  _lastLine = last;
+
+  // activate the edges started before the first line
+  while ((_nextEdge < _edges.size()) && (_edges[_nextEdge].firstLine < first)) {
+    if (_edges[_nextEdge].lastLine >= first) _active.push_back(_nextEdge);
+    _nextEdge++;
+  }
+}  // setLines()
+
+
+// Calculate the inner spans of the next line.
+bool _EdgeTable::nextLine() {
+  spans.clear();
+
+  _line++;
+  if (_line > _lastLine) return (false);
+  y = (int16_t)_line;
+
+  // update active edges
+  _active.erase(std::remove_if(_active.begin(), _active.end(), [&](size_t e) {
+                  return (_edges[e].lastLine < _line);
+                }),
+                _active.end());
+  while ((_nextEdge < _edges.size()) && (_edges[_nextEdge].firstLine <= _line)) {
+    _active.push_back(_nextEdge++);
+  }
+
+  int32_t lineY = 256 * _line;
+  _crossings.clear();
+  for (size_t e : _active) {
+    _crossings.push_back({ _edges[e].xAt(lineY), _edges[e].dir });
+  }
+  std::sort(_crossings.begin(), _crossings.end(), [](const _Crossing &c1, const _Crossing &c2) {
+    return (c1.x < c2.x);
+  });
+
+  // inner pixels have the center between crossings where the path is entered and left.
+  int16_t winding = 0;
+  int32_t xStart = 0;
+
+  for (const _Crossing &c : _crossings) {
+    bool wasInside = (winding != 0);
+    winding += c.dir;
+
+    if ((!wasInside) && (winding != 0)) {
+      xStart = c.x;
+    } else if ((wasInside) && (winding == 0)) {
+      int16_t x0 = (xStart + 255) >> 8;
+      int16_t x1 = ((c.x + 255) >> 8) - 1;
+      if (_clip.clipSpan(x0, x1, y)) spans.push_back({ x0, x1 });
+    }
+  }
+  return (true);
+}  // nextLine()
 
 
 /// @brief draw a path using a border and optional fill drawing function.
@@ -49,7 +49,9 @@ public:
   };
 
   Segment() = default;
-  Segment(Type _type, int16_t x = 0, int16_t y = 0);
+
+  constexpr Segment(Type _type, int16_t x = 0, int16_t y = 0)
+    : type(_type), p{ x, y, 0, 0, 0, 0 } {};
 
   Type type;
 
@@ -81,6 +83,62 @@ public:
   static Segment createArc(int16_t radius, bool f1, bool f2, int16_t xEnd, int16_t yEnd);
 };
 
+/// @brief Options for filling paths.
+enum FillFlags : uint16_t {
+  /// The inner pixels are found by tracing all border pixels into sorted edges (default).
+  EdgeTrace = 0x00,
+
+  /// Pixels are inside the path when the number of border crossings on the left is odd (default).
+  EvenOdd = 0x00,
+
+  /// Pixels are inside the path when the sum of the directions of the border crossings on the left is not zero.
+  /// Overlapping sub-paths with the same direction are filled completely.
+  NonZero = 0x01,
+
+  /// Large paths are filled in horizontal bands on multiple threads when available (host builds).
+  /// The callbacks are called in parallel for different lines and must be thread-safe.
+  /// The drawn pixels are the same as without this flag.
+  /// Only the lines are drawn in parallel, tracing the border and sorting the edges is done by the calling thread.
+  Parallel = 0x20,
+};
+
+/// Minimum number of lines of a path to use the parallel fill.
+#ifndef GFXDRAW_PARALLEL_LINES
+#define GFXDRAW_PARALLEL_LINES 128
+#endif
+
+inline FillFlags operator|(FillFlags a, FillFlags b) {
+  return static_cast<FillFlags>(static_cast<int>(a) | static_cast<int>(b));
+}
+
+/// @brief Line caps and joins for drawing paths with a stroke width.
+enum StrokeFlags : uint16_t {
+  /// The stroke ends at the end points of open sub-paths (default).
+  ButtCap = 0x00,
+
+  /// The stroke is extended by a half circle at the end points of open sub-paths.
+  RoundCap = 0x01,
+
+  /// The stroke is extended by a half square at the end points of open sub-paths.
+  SquareCap = 0x02,
+
+  /// The outer borders of 2 joined segments are extended until they meet (default).
+  /// Joins with a sharp angle where the miter from the inner to the outer corner is longer than 4 times the stroke
+  /// width are drawn as bevel joins like with the SVG default stroke-miterlimit="4".
+  MiterJoin = 0x00,
+
+  /// Segments are joined by a circle, also when a segment turns back by 180 degree.
+  RoundJoin = 0x10,
+
+  /// Segments are joined by a straight line between the outer borders.
+  BevelJoin = 0x20,
+};
+
+inline StrokeFlags operator|(StrokeFlags a, StrokeFlags b) {
+  return static_cast<StrokeFlags>(static_cast<int>(a) | static_cast<int>(b));
+}
+
+
 // ===== create and manipulate segments
 
 /// @brief Scan a path using the svg/path/d syntax to create a vector(array) of Segments.
@@ -90,6 +148,261 @@ public:
 std::vector<Segment> parsePath(const char *pathText);
 
 
+/// @brief Scan a path using the svg/path/d syntax into an array of Segments.
+/// This function is used by parsePath and by parsePathArray at compile time.
+/// @param pathText path definition as String
+/// @param segments Array receiving the segments or nullptr to count the segments only.
+/// @param size Size of the array.
+/// @return Number of segments in the path.
+constexpr size_t _scanPath(const char *pathText, Segment *segments, size_t size) {
+  char command = '-';
+  size_t count = 0;
+
+  const char *path = pathText;
+  int16_t lastX = 0, lastY = 0;
+
+  // second control point of the last curve or the last point, used for smooth curves.
+  int16_t ctrlX = 0, ctrlY = 0;
+
+  /// A lambda function to check for white space characters like isspace().
+  auto isSpace = [](char c) {
+    return ((c == ' ') || ((c >= '\t') && (c <= '\r')));
+  };
+
+  /// A lambda function to parse a numeric parameter from the inputText like strtol().
+  auto getNumParam = [&]() {
+    while (isSpace(*path) || (*path == ',')) { path++; }
+    const char *p = path;
+    bool negative = (*p == '-');
+    if ((*p == '-') || (*p == '+')) p++;
+
+    int32_t num = 0;
+    if ((*p >= '0') && (*p <= '9')) {
+      while ((*p >= '0') && (*p <= '9')) {
+        if (num < 100000) num = (num * 10) + (*p - '0');
+        p++;
+      }
+      path = p;
+    }
+    return (static_cast<int16_t>(negative ? -num : num));
+  };
+
+  /// A lambda function to parse a flag parameter from the inputText.
+  auto getBoolParam = [&]() {
+    while (isSpace(*path) || (*path == ',')) { path++; }
+    bool flag = (*path == '1');
+    if (*path) path++;
+    return (flag);
+  };
+
+  /// A lambda function to check for a command character.
+  auto isCommand = [](char c) {
+    for (const char *cmd = "MmLlCcSsZHhVvAazO"; *cmd; cmd++) {
+      if (c == *cmd) return (true);
+    }
+    return (false);
+  };
+
+  while (path && *path) {
+
+    if (isSpace(*path)) {
+      path++;
+
+    } else {
+      const char *segStart = path;
+      if (isCommand(*path))
+        command = *path++;
+
+      Segment Seg(static_cast<Segment::Type>(0));
+      bool f1 = false, f2 = false;  // flags
+
+      switch (command) {
+        case 'M':
+          Seg.type = Segment::Type::Move;
+          lastX = Seg.p[0] = getNumParam();
+          lastY = Seg.p[1] = getNumParam();
+          break;
+
+        case 'm':
+          // convert to absolute coordinates
+          Seg.type = Segment::Type::Move;
+          lastX = Seg.p[0] = lastX + getNumParam();
+          lastY = Seg.p[1] = lastY + getNumParam();
+          break;
+
+        case 'L':
+          Seg.type = Segment::Type::Line;
+          lastX = Seg.p[0] = getNumParam();
+          lastY = Seg.p[1] = getNumParam();
+          break;
+
+        case 'l':
+          // convert to absolute coordinates
+          Seg.type = Segment::Type::Line;
+          lastX = Seg.p[0] = lastX + getNumParam();
+          lastY = Seg.p[1] = lastY + getNumParam();
+          break;
+
+        case 'C':
+          // curve defined with absolute points - no convertion required
+          Seg.type = Segment::Type::Curve;
+          Seg.p[0] = getNumParam();
+          Seg.p[1] = getNumParam();
+          Seg.p[2] = getNumParam();
+          Seg.p[3] = getNumParam();
+          lastX = Seg.p[4] = getNumParam();
+          lastY = Seg.p[5] = getNumParam();
+          break;
+
+        case 'c':
+          // curve defined with relative points - convert to absolute coordinates
+          Seg.type = Segment::Type::Curve;
+          Seg.p[0] = lastX + getNumParam();
+          Seg.p[1] = lastY + getNumParam();
+          Seg.p[2] = lastX + getNumParam();
+          Seg.p[3] = lastY + getNumParam();
+          lastX = Seg.p[4] = lastX + getNumParam();
+          lastY = Seg.p[5] = lastY + getNumParam();
+          break;
+
+        case 'S':
+          // smooth curve with absolute points - the first control point is the reflection of the last control point.
+          Seg.type = Segment::Type::Curve;
+          Seg.p[0] = 2 * lastX - ctrlX;
+          Seg.p[1] = 2 * lastY - ctrlY;
+          Seg.p[2] = getNumParam();
+          Seg.p[3] = getNumParam();
+          lastX = Seg.p[4] = getNumParam();
+          lastY = Seg.p[5] = getNumParam();
+          break;
+
+        case 's':
+          // smooth curve with relative points - convert to absolute coordinates
+          Seg.type = Segment::Type::Curve;
+          Seg.p[0] = 2 * lastX - ctrlX;
+          Seg.p[1] = 2 * lastY - ctrlY;
+          Seg.p[2] = lastX + getNumParam();
+          Seg.p[3] = lastY + getNumParam();
+          lastX = Seg.p[4] = lastX + getNumParam();
+          lastY = Seg.p[5] = lastY + getNumParam();
+          break;
+
+        case 'H':
+          // Horizontal line with absolute horizontal end point coordinate - convert to absolute line
+          Seg.type = Segment::Type::Line;
+          lastX = Seg.p[0] = getNumParam();
+          Seg.p[1] = lastY;  // stay;
+          break;
+
+        case 'h':
+          // Horizontal line with relative horizontal end-point coordinate - convert to absolute line
+          Seg.type = Segment::Type::Line;
+          lastX = Seg.p[0] = lastX + getNumParam();
+          Seg.p[1] = lastY;  // stay;
+          break;
+
+        case 'V':
+          // Vertical line with absolute vertical end point coordinate - convert to absolute line
+          Seg.type = Segment::Type::Line;
+          Seg.p[0] = lastX;  // stay;
+          lastY = Seg.p[1] = getNumParam();
+          break;
+
+        case 'v':
+          // Vertical line with relative horizontal end-point coordinate - convert to absolute line
+          Seg.type = Segment::Type::Line;
+          Seg.p[0] = lastX;  // stay;
+          lastY = Seg.p[1] = lastY + getNumParam();
+          break;
+
+        case 'A':
+          // Ellipsis arc with absolute end-point coordinates.
+          Seg.type = Segment::Type::Arc;
+          Seg.p[0] = getNumParam();  // rx
+          Seg.p[1] = getNumParam();  // ry
+          Seg.p[2] = getNumParam();  // rotation
+          f1 = getBoolParam();
+          f2 = getBoolParam();
+          Seg.p[3] = (f1 ? 0x01 : 0x00) + (f2 ? 0x02 : 0x00);  // flags
+          lastX = Seg.p[4] = getNumParam();
+          lastY = Seg.p[5] = getNumParam();
+          break;
+
+        case 'a':
+          // Ellipsis arc with relative end-point coordinates.
+          Seg.type = Segment::Type::Arc;
+          Seg.p[0] = getNumParam();  // rx
+          Seg.p[1] = getNumParam();  // ry
+          Seg.p[2] = getNumParam();  // rotation
+          f1 = getBoolParam();
+          f2 = getBoolParam();
+          Seg.p[3] = (f1 ? 0x01 : 0x00) + (f2 ? 0x02 : 0x00);  // flags
+          lastX = Seg.p[4] = lastX + getNumParam();
+          lastY = Seg.p[5] = lastY + getNumParam();
+          break;
+
+        case 'z':
+        case 'Z':
+          Seg.type = Segment::Type::Close;
+          break;
+
+          // non svg path types:
+        case 'O':
+          // Draw a whole circle by center and radius
+          Seg.type = Segment::Type::Circle;
+          Seg.p[0] = getNumParam();  // Center.x
+          Seg.p[1] = getNumParam();  // Center.y
+          Seg.p[2] = getNumParam();  // radius
+          lastX = lastY = 0;
+          break;
+      }
+
+      if (path == segStart) {
+        // nothing was parsed, skip the unknown character to avoid an endless loop.
+        path++;
+
+      } else {
+        if (Seg.type == Segment::Type::Curve) {
+          ctrlX = Seg.p[2];
+          ctrlY = Seg.p[3];
+        } else {
+          ctrlX = lastX;
+          ctrlY = lastY;
+        }
+        if (count < size) segments[count] = Seg;
+        count++;
+      }
+    }
+  }
+  return (count);
+}  // _scanPath()
+
+
+/// @brief Count the segments of a path at compile time.
+/// @param pathText path definition as String
+/// @return Number of segments in the path.
+constexpr size_t pathSegmentCount(const char *pathText) {
+  return (_scanPath(pathText, nullptr, 0));
+}
+
+
+/// @brief Scan a path using the svg/path/d syntax at compile time into an array of Segments.
+/// The GFXDRAW_PATH macro can be used to calculate the number of segments.
+/// @param pathText path definition as String literal.
+/// @return Array with Segments.
+/// @example static constexpr std::array<Segment, 5> segs = parsePathArray<5>("M4 8l12-6l10 10h-8v4h-6z");
+template<size_t N>
+constexpr std::array<Segment, N> parsePathArray(const char *pathText) {
+  std::array<Segment, N> segments{};
+  _scanPath(pathText, segments.data(), N);
+  return (segments);
+}
+
+/// @brief Create a std::array of Segments from a path String literal at compile time.
+/// @example static constexpr auto segs = GFXDRAW_PATH("M4 8l12-6l10 10h-8v4h-6z");
+#define GFXDRAW_PATH(pathText) gfxDraw::parsePathArray<gfxDraw::pathSegmentCount(pathText)>(pathText)
+
+
 /// @brief Draw the border line of a path.
 // void kath(const char *pathText, fSetPixel cbDraw);
 
@@ -99,17 +412,37 @@ std::vector<Segment> parsePath(const char *pathText);
 /// @param base scaling base, defaults to 100.
 void scaleSegments(std::vector<Segment> &segments, int16_t factor, int16_t base = 100);
 
+/// @brief scale all points by factor / base.
+/// @param segments Segments to be changed
+/// @param count Number of segments
+/// @param factor scaling factor
+/// @param base scaling base, defaults to 100.
+void scaleSegments(Segment *segments, size_t count, int16_t factor, int16_t base = 100);
+
 /// @brief rotate all points by the given angle.
 /// @param segments Segment vector to be changed
 /// @param angle angle 0...360
 void rotateSegments(std::vector<Segment> &segments, int16_t angle);
 
+/// @brief rotate all points by the given angle.
+/// @param segments Segments to be changed
+/// @param count Number of segments
+/// @param angle angle 0...360
+void rotateSegments(Segment *segments, size_t count, int16_t angle);
+
 /// @brief move all points by the given offset in x and y.
 /// @param segments Segment vector to be changed
 /// @param dx X-Offset
 /// @param dy Y-Offset
 void moveSegments(std::vector<Segment> &segments, int16_t dx, int16_t dy);
 
+/// @brief move all points by the given offset in x and y.
+/// @param segments Segments to be changed
+/// @param count Number of segments
+/// @param dx X-Offset
+/// @param dy Y-Offset
+void moveSegments(Segment *segments, size_t count, int16_t dx, int16_t dy);
+
 /// @brief move all points by the given offset in x and y.
 /// @param segments Segment vector to be changed
 /// @param moveVector X- and Y- Offset as Point-Vector.
@@ -119,15 +452,123 @@ void moveSegments(std::vector<Segment> &segments, Point moveVector);
 /// @brief Transform all points in the segments
 void transformSegments(std::vector<Segment> &segments, fTransform cbTransform);
 
+/// @brief Transform all points in the segments
+void transformSegments(Segment *segments, size_t count, fTransform cbTransform);
+
+
+/// @brief A rectangle of pixels from (x0, y0) to (x1, y1), both including.
+struct BoundingBox {
+  int16_t x0 = INT16_MAX;
+  int16_t y0 = INT16_MAX;
+  int16_t x1 = INT16_MIN;
+  int16_t y1 = INT16_MIN;
+
+  /// @brief true when no point was added.
+  bool isEmpty() const {
+    return (x0 > x1);
+  }
+
+  /// @brief Extend the box to include a rectangle around a point.
+  void extend(int32_t x, int32_t y, int32_t margin = 0) {
+    if (x - margin < x0) x0 = (int16_t)(x - margin < INT16_MIN ? INT16_MIN : x - margin);
+    if (x + margin > x1) x1 = (int16_t)(x + margin > INT16_MAX ? INT16_MAX : x + margin);
+    if (y - margin < y0) y0 = (int16_t)(y - margin < INT16_MIN ? INT16_MIN : y - margin);
+    if (y + margin > y1) y1 = (int16_t)(y + margin > INT16_MAX ? INT16_MAX : y + margin);
+  }
+};
+
+/// @brief Calculate a box that contains all pixels drawn for the segments.
+/// The box is conservative: curves are covered by their control points and arcs and circles by the box of the full
+/// ellipse or circle, so the box can be larger than the drawn pixels but is cheap to calculate.
+/// @param segments Vector of the segments of the path.
+/// @return The bounding box, empty for no segments.
+BoundingBox boundingBox(const std::vector<Segment> &segments);
+
+/// @brief Calculate a box that contains all pixels drawn for the segments.
+/// @param segments Array of the segments of the path.
+/// @param count Number of segments.
+/// @return The bounding box, empty for no segments.
+BoundingBox boundingBox(const Segment *segments, size_t count);
+
 
 /// @brief Draw a path without filling.
 /// @param segments Vector of the segments of the path.
 /// @param cbDraw Callback with coordinates of line pixels.
 void drawSegments(std::vector<Segment> &segments, fSetPixel cbDraw);
 
+/// @brief Draw a path without filling.
+/// @param segments Array of the segments of the path, e.g. from parsePathArray.
+/// @param count Number of segments.
+/// @param cbDraw Callback with coordinates of line pixels.
+void drawSegments(const Segment *segments, size_t count, fSetPixel cbDraw);
+
+/// @brief Draw a path without filling using a stroke width.
+/// The stroke is converted into an outline that is filled once by the active edge table.
+/// Strokes with a width of 1 are drawn like drawSegments without a width.
+/// @param segments Array of the segments of the path.
+/// @param count Number of segments.
+/// @param width Width of the stroke in pixels.
+/// @param cbDraw Callback with horizontal sequences of stroke pixels.
+/// @param flags Line caps and joins.
+void drawSegments(const Segment *segments, size_t count, int16_t width, fDrawSpan cbDraw, StrokeFlags flags = StrokeFlags::ButtCap);
+
+/// @brief Draw a path without filling using a stroke width.
+/// @param segments Array of the segments of the path.
+/// @param count Number of segments.
+/// @param width Width of the stroke in pixels.
+/// @param cbDraw Callback with coordinates of stroke pixels.
+/// @param flags Line caps and joins.
+void drawSegments(const Segment *segments, size_t count, int16_t width, fSetPixel cbDraw, StrokeFlags flags = StrokeFlags::ButtCap);
+
+/// @brief Draw a path without filling using a stroke width.
+/// @param segments Vector of the segments of the path.
+/// @param width Width of the stroke in pixels.
+/// @param cbDraw Callback with horizontal sequences of stroke pixels.
+/// @param flags Line caps and joins.
+void drawSegments(std::vector<Segment> &segments, int16_t width, fDrawSpan cbDraw, StrokeFlags flags = StrokeFlags::ButtCap);
+
+/// @brief Draw a path without filling using a stroke width.
+/// @param segments Vector of the segments of the path.
+/// @param width Width of the stroke in pixels.
+/// @param cbDraw Callback with coordinates of stroke pixels.
+/// @param flags Line caps and joins.
+void drawSegments(std::vector<Segment> &segments, int16_t width, fSetPixel cbDraw, StrokeFlags flags = StrokeFlags::ButtCap);
+
 /// @brief Draw a path with filling.
 // void fillSegments(std::vector<Segment> &segments, int16_t dx, int16_t dy, fSetPixel cbBorder, fSetPixel cbFill = nullptr);
-void fillSegments(std::vector<Segment> &segments, fSetPixel cbBorder, fSetPixel cbFill = nullptr);
+void fillSegments(std::vector<Segment> &segments, fSetPixel cbBorder, fSetPixel cbFill = nullptr, FillFlags flags = FillFlags::EdgeTrace);
+
+/// @brief Draw a path with filling where the inner pixels are passed as horizontal spans.
+/// @param segments Vector of the segments of the path.
+/// @param cbBorder Callback with coordinates of border pixels. cbFill is used when cbBorder is null.
+/// @param cbFill Callback with horizontal sequences of fill pixels.
+/// @param flags Options for the fill algorithm.
+void fillSegments(std::vector<Segment> &segments, fSetPixel cbBorder, fDrawSpan cbFill, FillFlags flags = FillFlags::EdgeTrace);
+
+/// @brief Draw a path with filling.
+/// @param segments Array of the segments of the path, e.g. from parsePathArray.
+/// @param count Number of segments.
+void fillSegments(const Segment *segments, size_t count, fSetPixel cbBorder, fSetPixel cbFill = nullptr, FillFlags flags = FillFlags::EdgeTrace);
+
+/// @brief Draw a path with filling where the inner pixels are passed as horizontal spans.
+/// @param segments Array of the segments of the path, e.g. from parsePathArray.
+/// @param count Number of segments.
+void fillSegments(const Segment *segments, size_t count, fSetPixel cbBorder, fDrawSpan cbFill, FillFlags flags = FillFlags::EdgeTrace);
+
+/// @brief Draw a path with filling using any callables for border and fill.
+/// The callables can be inlined by the compiler into the scanline loop.
+/// @param segments Vector of the segments of the path.
+/// @param cbBorder Callable with coordinates of border pixels or nullptr. cbFill is used when cbBorder is null.
+/// @param cbFill Callable with coordinates of fill pixels (x, y) or with horizontal sequences of fill pixels (x0, x1, y).
+/// @param flags Options for the fill algorithm.
+template<typename TBorder, typename TFill>
+void fillSegments(std::vector<Segment> &segments, TBorder &&cbBorder, TFill &&cbFill, FillFlags flags = FillFlags::EdgeTrace);
+
+/// @brief Draw a path with filling using any callables for border and fill.
+/// @param segments Array of the segments of the path, e.g. from parsePathArray.
+/// @param count Number of segments.
+template<typename TBorder, typename TFill>
+void fillSegments(const Segment *segments, size_t count, TBorder &&cbBorder, TFill &&cbFill, FillFlags flags = FillFlags::EdgeTrace);
 
 
 /// @brief draw a path using a border and optional fill drawing function.
@@ -140,6 +581,303 @@ void fillSegments(std::vector<Segment> &segments, fSetPixel cbBorder, fSetPixel
 void pathByText(const char *pathText, int16_t x, int16_t y, int16_t scale100, fSetPixel cbBorder, fSetPixel cbFill);
 
 
+// ===== internal scanline fill functionality =====
+
+/// @brief The _Edge class holds a horizontal pixel sequence for path boundaries and provides some useful static methods.
+class _Edge : public Point {
+public:
+  _Edge(int16_t _x, int16_t _y)
+    : Point(_x, _y), len(1), dir(0) {};
+
+  uint16_t len;
+
+  /// @brief direction of the border at this edge: +1 for ascending y, -1 for descending y.
+  int8_t dir;
+
+  /// @brief compare function for std::sort to sort points by (y) and ascending (x)
+  /// @param p1 first Edge-point
+  /// @param p2 second Edge-point
+  /// @return when p1 is lower than p2
+  static bool compare(const _Edge &p1, const _Edge &p2) {
+    if (p1.y != p2.y)
+      return (p1.y < p2.y);
+    if (p1.x != p2.x)
+      return (p1.x < p2.x);
+    return (p1.len < p2.len);
+  };
+
+  /// @brief add another point or Edge to the Edge
+  /// @param p2
+  /// @return true when this Edge could be expanded.
+  bool expand(_Edge p2) {
+    if (y == p2.y) {
+      if (x > p2.x + p2.len) {
+        // no
+        return (false);
+      } else if (x + len < p2.x) {
+        // no
+        return (false);
+
+      } else {
+        // overlapping or joining edges
+        int16_t left = (x < p2.x ? x : p2.x);
+        int16_t right = (x + len > p2.x + p2.len ? x + len : p2.x + p2.len);
+        x = left;
+        len = right - left;
+        return (true);
+      }
+    }
+    return (false);
+  };
+};
+
+
+/// @brief Draw the pixels of a path like drawSegments without counting them as border pixels in the statistics.
+/// @param segments Vector of the segments of the path.
+/// @param cbDraw Callback with coordinates of line pixels and (0, POINT_BREAK_Y) after every sub-path.
+void _drawSegments(const Segment *segments, size_t count, fSetPixel cbDraw);
+
+
+/// @brief Trace the path and collect all edges sorted by lines (y) and ascending (x) for the scanline fill.
+/// @param segments Vector of the segments of the path.
+/// @param edges Vector receiving the edges.
+void _collectEdges(const Segment *segments, size_t count, std::vector<_Edge> &edges);
+
+
+/// @brief Draw the border and fill pixels of the sorted edges using the scanline fill algorithm.
+/// @param edges sorted edges from _collectEdges.
+/// @param count number of edges, all edges of a line must be included.
+/// @param cbBorder Callable for border pixels or nullptr. cbFill is used when cbBorder is null.
+/// @param cbFill Callable for fill pixels or spans.
+/// @param flags Fill rule in FillFlags.
+/// @param clip The clip rectangle of the calling thread.
+template<typename TBorder, typename TFill>
+void _fillEdges(const _Edge *edges, size_t count, TBorder &cbBorder, TFill &cbFill, FillFlags flags, const ClipRect clip) {
+  bool hasBorder = _isCallback(cbBorder);
+  bool hasFill = _isCallback(cbFill);
+  bool nonZero = (flags & FillFlags::NonZero);
+
+  int16_t y = INT16_MAX;
+  int16_t x = INT16_MAX;
+
+  bool isInside = false;
+  int16_t winding = 0;
+
+  // skip the lines above the clip rectangle
+  size_t first = std::lower_bound(edges, edges + count, clip.y0, [](const _Edge &e, int16_t y) {
+                   return (e.y < y);
+                 })
+                 - edges;
+
+  // Draw borderpoints and lines on inner segments
+  for (size_t n = first; n < count; n++) {
+    const _Edge &p = edges[n];
+    if (p.y > clip.y1) break;
+
+    if (p.y != y) {
+      // start a new line
+      isInside = false;
+      winding = 0;
+      y = p.y;
+      x = INT16_MIN;
+    }
+
+    if (y == POINT_BREAK_Y) continue;
+
+    // pixels of overlapping borders are drawn only once.
+    int16_t x0 = (p.x > x ? p.x : x);
+    int16_t x1 = p.x + p.len - 1;
+
+    if ((p.len == 0) || (x0 > x1)) {
+      // don't draw, it is just an marker for a extreme sequence or already drawn.
+
+    } else if (!clip.clipSpan(x0, x1, y)) {
+      // the border is outside the clip rectangle
+
+    } else if (hasBorder) {
+      // draw the border
+      GFXDRAW_STAT(borderPixels, x1 - x0 + 1);
+      _drawSpan(cbBorder, x0, x1, y);
+
+    } else if (hasFill) {
+      // draw the border using the fill
+      GFXDRAW_STAT(borderPixels, x1 - x0 + 1);
+      _drawSpan(cbFill, x0, x1, y);
+    }
+
+    // draw the fill
+    x0 = x;
+    x1 = p.x - 1;
+    if ((isInside) && (hasFill) && (clip.clipSpan(x0, x1, y))) {
+      GFXDRAW_STAT(fillPixels, x1 - x0 + 1);
+      _drawSpan(cbFill, x0, x1, y);
+    }
+    if (nonZero) {
+      winding += p.dir;
+      isInside = (winding != 0);
+    } else {
+      isInside = (!isInside);
+    }
+    if (p.x + p.len > x) x = p.x + p.len;
+  }
+}  // _fillEdges()
+
+
+/// @brief Draw the sorted edges in horizontal bands on multiple threads.
+/// The bands are split at line boundaries so every line is drawn the same way as by a single _fillEdges call.
+/// The edges are traced and sorted before by the calling thread and the bands use the clip rectangle of this thread.
+template<typename TBorder, typename TFill>
+void _fillEdgesParallel(std::vector<_Edge> &edges, TBorder &cbBorder, TFill &cbFill, FillFlags flags) {
+  const ClipRect clip = _clipRect;
+
+  // the edges of sub-path breaks are sorted to the end and are not drawn.
+  size_t eSize = edges.size();
+  while ((eSize > 0) && (edges[eSize - 1].y == POINT_BREAK_Y)) eSize--;
+
+  int32_t lines = (eSize > 0) ? (edges[eSize - 1].y - edges[0].y + 1) : 0;
+  int32_t bands = 4 * _parallelThreads();
+  if (bands > lines / 32) bands = lines / 32;
+
+  if ((bands <= 1) || (lines < GFXDRAW_PARALLEL_LINES)) {
+    _fillEdges(edges.data(), eSize, cbBorder, cbFill, flags, clip);
+    return;
+  }
+
+  std::vector<size_t> bounds(bands + 1);
+  for (int32_t b = 0; b < bands; b++) {
+    int16_t y = edges[0].y + (lines * b) / bands;
+    bounds[b] = std::lower_bound(edges.begin(), edges.begin() + eSize, y, [](const _Edge &e, int16_t y) {
+                  return (e.y < y);
+                })
+                - edges.begin();
+  }
+  bounds[bands] = eSize;
+
+  _parallelFor(bands, [&](int16_t b) {
+    _fillEdges(edges.data() + bounds[b], bounds[b + 1] - bounds[b], cbBorder, cbFill, flags, clip);
+  });
+}  // _fillEdgesParallel()
+
+
+// ===== internal active edge table functionality for strokes =====
+
+/// @brief A horizontal sequence of pixels from x0 to x1 (both including).
+struct _Span {
+  int16_t x0;
+  int16_t x1;
+};
+
+
+/// @brief The _EdgeTable flattens the outline of a stroke into line edges and calculates the inner pixels line by line
+/// using an active edge table.
+/// The inner pixels are the pixels with the center inside the flattened outline.
+/// Only the lines and spans inside the clip rectangle at construction time are calculated.
+class _EdgeTable {
+public:
+  /// @brief Flatten the segments of a path into the outline of a stroke.
+  /// The outline is made of overlapping polygons for the lines, joins and caps that are all oriented in the same
+  /// direction and are filled using the NonZero rule.
+  /// @param segments Vector of the segments of the path.
+  /// @param width Width of the stroke in pixels.
+  /// @param flags Line caps and joins.
+  _EdgeTable(const Segment *segments, size_t count, int16_t width, StrokeFlags flags);
+
+  /// @brief Restrict the calculation to a range of lines.
+  /// This can be used on copies of the table to calculate bands of lines in parallel.
+  /// @param first first line
+  /// @param last last line
+  void setLines(int32_t first, int32_t last);
+
+  /// @brief Calculate the inner spans of the next line.
+  /// @return false when all lines are done.
+  bool nextLine();
+
+  /// @brief The first line with edges inside the clip rectangle.
+  int32_t firstLine = 0;
+
+  /// @brief The last line with edges inside the clip rectangle.
+  int32_t lastLine = -1;
+
+  /// @brief The current line.
+  int16_t y = 0;
+
+  /// @brief The inner spans of the current line in ascending order.
+  std::vector<_Span> spans;
+
+private:
+  /// @brief A line edge of the flattened path with coordinates in 1/256 pixel units and y0 < y1.
+  struct _LineEdge {
+    int32_t x0;
+    int32_t y0;
+    int32_t x1;
+    int32_t y1;
+    int32_t firstLine;  // first line the edge is crossing
+    int32_t lastLine;   // last line the edge is crossing
+    int8_t dir;         // +1 for ascending y, -1 for descending y of the path
+
+    /// @brief x coordinate of the edge at y
+    int32_t xAt(int32_t y) const {
+      return (x0 + (int32_t)((int64_t)(y - y0) * (x1 - x0) / (y1 - y0)));
+    }
+  };
+
+  /// @brief A point of a flattened sub-path in 1/256 pixel units.
+  struct _Point256 {
+    int32_t x;
+    int32_t y;
+  };
+
+  void _addSegments(const Segment *segments, size_t count);
+  void _sortEdges();
+  void _addEdge(int32_t x0, int32_t y0, int32_t x1, int32_t y1);
+  void _addLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1);
+  void _addPolygon(const _Point256 *points, size_t count);
+  void _addDisc(int32_t cx, int32_t cy, int32_t radius);
+  void _strokeEnd(bool closed);
+  void _addCurve(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3);
+  void _addArc(int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t rx, int16_t ry, int16_t phi, int16_t flags);
+  void _addCircle(int16_t cx, int16_t cy, int16_t radius);
+
+  std::vector<_LineEdge> _edges;  // all edges sorted by firstLine
+  std::vector<size_t> _active;    // index of the edges crossing the current line
+  size_t _nextEdge = 0;
+  int32_t _line = 0;
+  int32_t _lastLine = -1;
+
+  /// @brief x position and direction of an edge crossing the current line.
+  struct _Crossing {
+    int32_t x;
+    int8_t dir;
+  };
+
+  std::vector<_Crossing> _crossings;  // edges crossing the current line
+  ClipRect _clip;                     // the spans are restricted to the clip rectangle
+
+  int32_t _halfWidth = 0;           // half stroke width in 1/256 pixel units
+  StrokeFlags _strokeFlags = StrokeFlags::ButtCap;
+  std::vector<_Point256> _polyline;  // points of the current sub-path
+};
+
+
+template<typename TBorder, typename TFill>
+void fillSegments(const Segment *segments, size_t count, TBorder &&cbBorder, TFill &&cbFill, FillFlags flags) {
+  GFXDRAW_STATS_SCOPE(statsScope);
+  std::vector<_Edge> edges;
+  _collectEdges(segments, count, edges);
+  if (flags & FillFlags::Parallel) {
+    _fillEdgesParallel(edges, cbBorder, cbFill, flags);
+  } else {
+    _fillEdges(edges.data(), edges.size(), cbBorder, cbFill, flags, _clipRect);
+  }
+}  // fillSegments()
+
+
+template<typename TBorder, typename TFill>
+void fillSegments(std::vector<Segment> &segments, TBorder &&cbBorder, TFill &&cbFill, FillFlags flags) {
+  fillSegments(segments.data(), segments.size(), std::forward<TBorder>(cbBorder), std::forward<TFill>(cbFill), flags);
+}  // fillSegments()
+
+
 
 }  // gfxDraw:: namespace
 
@@ -41,12 +41,29 @@ void gfxDrawPathWidget::setConfig(gfxDrawPathConfig *c) {
 /// @brief Create segments from a textual path definition.
 void gfxDrawPathWidget::setPath(const char *path) { 
   _segments = parsePath(path);
+  _arraySegments = nullptr;
+  _pathVersion++;
+  _initMatrix(_matrix);
+}
+
+/// @brief Set the segments from an array without copying them.
+void gfxDrawPathWidget::setPath(const Segment *segments, size_t count) {
+  _segments.clear();
+  _arraySegments = segments;
+  _arrayCount = count;
+  _pathVersion++;
   _initMatrix(_matrix);
 }
 
 /// @brief add a segment to the path.
 void gfxDrawPathWidget::addSegment(Segment s) {
+  if (_arraySegments) {
+    // the external array cannot be extended
+    _segments.assign(_arraySegments, _arraySegments + _arrayCount);
+    _arraySegments = nullptr;
+  }
   _segments.push_back(s);
+  _pathVersion++;
 }
 
 
@@ -95,10 +112,8 @@ void gfxDrawPathWidget::rotate(int16_t angle, int16_t cx, int16_t cy) {
       _multiplyMatrix(_matrix, m);
     }
 
-    double radians = (angle * M_PI) / 180;
-
-    int32_t sinFactor1000 = std::lround(sin(radians) * 1000);
-    int32_t cosFactor1000 = std::lround(cos(radians) * 1000);
+    int32_t sinFactor1000, cosFactor1000;
+    sinCos1000(angle, sinFactor1000, cosFactor1000);
 
     _initMatrix(m);
     m[0][0] = m[1][1] = cosFactor1000;
@@ -120,16 +135,9 @@ void gfxDrawPathWidget::rotate(int16_t angle, int16_t cx, int16_t cy) {
 
 // ===== Drawing =====
 
-void gfxDrawPathWidget::_extendBox(int16_t x, int16_t y) {
-  if (x < x_min) { x_min = x; }
-  if (x > x_max) { x_max = x; }
-
-  if (y < y_min) { y_min = y; }
-  if (y > y_max) { y_max = y; }
-}
-
 void gfxDrawPathWidget::draw(gfxDraw::fDrawPixel cbDraw) {
   GFX_TRACE("draw()");
+  GFXDRAW_STATS_SCOPE(statsScope);
   GFX_TRACE(" stroke= %08lX", _stroke.raw);
   GFX_TRACE(" fill  = %08lX", _fillColor1.raw);
 
@@ -138,52 +146,187 @@ void gfxDrawPathWidget::draw(gfxDraw::fDrawPixel cbDraw) {
   x_max = INT16_MIN;
   y_max = INT16_MIN;
 
-  // create a copy
-  std::vector<gfxDraw::Segment> tSegments = _segments;
+  if ((_tVersion != _pathVersion) || (memcmp(_tMatrix, _matrix, sizeof(Matrix1000)) != 0)) {
+    // create a copy and transform with matrix
+    GFX_TRACE(" transform");
+    if (_arraySegments) {
+      _tSegments.assign(_arraySegments, _arraySegments + _arrayCount);
+    } else {
+      _tSegments = _segments;
+    }
+    transformSegments(_tSegments, [&](int16_t &x, int16_t &y) {
+      int32_t tx, ty;
+      tx = x * _matrix[0][0] + y * _matrix[0][1] + _matrix[0][2] + 500;
+      ty = x * _matrix[1][0] + y * _matrix[1][1] + _matrix[1][2] + 500;
+
+      x = tx / 1000;
+      y = ty / 1000;
+    });
+    memcpy(_tMatrix, _matrix, sizeof(Matrix1000));
+
+    // scale a wide stroke by the square root of the area scaling.
+    _tStrokeWidth = 1;
+    if (_strokeWidth > 1) {
+      int64_t det = ((int64_t)_matrix[0][0] * _matrix[1][1]) - ((int64_t)_matrix[0][1] * _matrix[1][0]);
+      _tStrokeWidth = (int16_t)((_strokeWidth * isqrt((uint64_t)(det < 0 ? -det : det)) + 500) / 1000);
+    }
+
+    // the box of the path including the stroke
+    _tBox = boundingBox(_tSegments);
+    if (!_tBox.isEmpty()) {
+      _tBox.extend(_tBox.x0, _tBox.y0, (_tStrokeWidth / 2) + 1);
+      _tBox.extend(_tBox.x1, _tBox.y1, (_tStrokeWidth / 2) + 1);
+    }
 
-  // transform with matrix
-  transformSegments(tSegments, [&](int16_t &x, int16_t &y) {
-    int32_t tx, ty;
-    tx = x * _matrix[0][0] + y * _matrix[0][1] + _matrix[0][2] + 500;
-    ty = x * _matrix[1][0] + y * _matrix[1][1] + _matrix[1][2] + 500;
+    _tVersion = _pathVersion;
+    _spansMode = -1;
+  }
 
-    x = tx / 1000;
-    y = ty / 1000;
-  });
+  // cull widgets outside the clip rectangle before tracing or filling the path.
+  const ClipRect clip = _clipRect;
+  if ((_tBox.isEmpty()) || (!clip.intersects(_tBox.x0, _tBox.y0, _tBox.x1, _tBox.y1))) {
+    GFX_TRACE(" not visible");
+    return;
+  }
+  x_min = (_tBox.x0 < clip.x0) ? clip.x0 : _tBox.x0;
+  y_min = (_tBox.y0 < clip.y0) ? clip.y0 : _tBox.y0;
+  x_max = (_tBox.x1 > clip.x1) ? clip.x1 : _tBox.x1;
+  y_max = (_tBox.y1 > clip.y1) ? clip.y1 : _tBox.y1;
+
+  // drawing mode: 0 = border only, 1 = border and fill, 2 = fill only, 3 = wide stroke only, 4 = fill and wide stroke
+  bool wide = (_tStrokeWidth > 1) && (_stroke.Alpha > 0);
+  int8_t mode = wide ? ((_fillColor1.Alpha == 0) ? 3 : 4) : (_fillColor1.Alpha == 0) ? 0 : (_stroke.Alpha > 0) ? 1 : 2;
+
+  if (_spanCache) {
+    if (_spansMode != mode) {
+      // trace and fill the whole path into the cache, the clip rectangle is applied when replaying.
+      GFX_TRACE(" create spans");
+      ClipScope noClip;
+      _spans.clear();
+      if (wide) {
+        if (mode == 4) {
+          gfxDraw::fillSegments(
+            _tSegments,
+            nullptr,
+            [&](int16_t x0, int16_t x1, int16_t y) {
+              _addSpan(x0, x1, y, false);
+            });
+        }
+        gfxDraw::drawSegments(
+          _tSegments, _tStrokeWidth,
+          [&](int16_t x0, int16_t x1, int16_t y) {
+            _addSpan(x0, x1, y, true);
+          },
+          _strokeFlags);
+
+      } else if (mode == 0) {
+        gfxDraw::drawSegments(_tSegments, [&](int16_t x, int16_t y) {
+          if (y < POINT_INVALID_Y) _addSpan(x, x, y, true);
+        });
+
+      } else if (mode == 1) {
+        gfxDraw::fillSegments(
+          _tSegments,
+          [&](int16_t x, int16_t y) {
+            _addSpan(x, x, y, true);
+          },
+          [&](int16_t x0, int16_t x1, int16_t y) {
+            _addSpan(x0, x1, y, false);
+          });
+
+      } else {
+        gfxDraw::fillSegments(
+          _tSegments,
+          nullptr,
+          [&](int16_t x0, int16_t x1, int16_t y) {
+            _addSpan(x0, x1, y, false);
+          });
+      }
+      _spans.shrink_to_fit();
+      _spansMode = mode;
+    }
 
-  // draw...
-  if (_fillColor1.Alpha == 0) {
+    // replay the spans
+    for (const _CacheSpan &s : _spans) {
+      ARGB color = (s.isBorder ? _stroke : _fillColor1);
+      int16_t x0 = s.x0;
+      int16_t x1 = s.x1;
+      if (clip.clipSpan(x0, x1, s.y)) {
+        for (int16_t x = x0; x <= x1; x++) {
+          cbDraw(x, s.y, color);
+        }
+      }
+    }
+
+  } else if (wide) {
+    // fill the path and draw the stroke on top
+    if (_fillColor1.Alpha > 0) {
+      gfxDraw::fillSegments(
+        _tSegments,
+        nullptr,
+        [&](int16_t x, int16_t y) {
+          cbDraw(x, y, _fillColor1);
+        });
+    }
+    gfxDraw::drawSegments(
+      _tSegments, _tStrokeWidth,
+      [&](int16_t x, int16_t y) {
+        cbDraw(x, y, _stroke);
+      },
+      _strokeFlags);
+
+  } else if (_fillColor1.Alpha == 0) {
     // need to draw the border pixels only
-    gfxDraw::drawSegments(tSegments, [&](int16_t x, int16_t y) {
+    gfxDraw::drawSegments(_tSegments, [&](int16_t x, int16_t y) {
       if (y < POINT_INVALID_Y) {
-        _extendBox(x, y);
         cbDraw(x, y, _stroke);
       }
     });
 
   } else if ((_stroke.Alpha > 0)) {
     gfxDraw::fillSegments(
-      tSegments,
+      _tSegments,
       [&](int16_t x, int16_t y) {
-        _extendBox(x, y);
         cbDraw(x, y, _stroke);
       },
       [&](int16_t x, int16_t y) {
-        _extendBox(x, y);
         cbDraw(x, y, _fillColor1);
       });
 
   } else if (_stroke.Alpha == 0) {
     gfxDraw::fillSegments(
-      tSegments,
+      _tSegments,
       nullptr,
       [&](int16_t x, int16_t y) {
-        _extendBox(x, y);
         cbDraw(x, y, _fillColor1);
       });
   }
 };
 
+
+void gfxDrawPathWidget::setSpanCache(bool enable) {
+  _spanCache = enable;
+  if (!enable) {
+    // free the memory
+    std::vector<_CacheSpan>().swap(_spans);
+    _spansMode = -1;
+  }
+}
+
+
+void gfxDrawPathWidget::_addSpan(int16_t x0, int16_t x1, int16_t y, bool isBorder) {
+  if (!_spans.empty()) {
+    _CacheSpan &last = _spans.back();
+    if ((last.y == y) && (last.isBorder == isBorder) && (last.x1 + 1 == x0)) {
+      // extend the last span
+      last.x1 = x1;
+      return;
+    }
+  }
+  _spans.push_back({ x0, x1, y, isBorder });
+}
+
+
 // ===== gradient filling =====
 
 void gfxDrawPathWidget::setStrokeColor(gfxDraw::ARGB stroke) {
@@ -196,6 +339,13 @@ void gfxDrawPathWidget::setFillColor(gfxDraw::ARGB fill) {
   _fillColor1 = fill;
 };
 
+void gfxDrawPathWidget::setStrokeWidth(int16_t width, StrokeFlags flags) {
+  GFX_TRACE("gfx::setStrokeWidth %d", width);
+  _strokeWidth = width;
+  _strokeFlags = flags;
+  _tVersion = 0;  // re-calculate the transformed width and the spans
+};
+
 /// ===== Transformations
 
 // Initialize a transformation matrix
@@ -50,11 +50,22 @@ public:
 
   void setFillColor(gfxDraw::ARGB fill);
 
+  /// @brief Set the width of the stroke.
+  /// A width > 1 is scaled by the transformation, a width of 1 draws the border pixels only.
+  /// @param width Width of the stroke in pixels.
+  /// @param flags Line caps and joins of the stroke.
+  void setStrokeWidth(int16_t width, StrokeFlags flags = StrokeFlags::ButtCap);
+
   // ===== path creation functions =====
 
   /// @brief Create segments from a textual path definition.
   void setPath(const char *path);
 
+  /// @brief Set the segments from an array, e.g. created by GFXDRAW_PATH at compile time.
+  /// The array is not copied and must stay valid while the widget is used, e.g. a static or constexpr array.
+  /// A later addSegment copies the array into the widget.
+  void setPath(const Segment *segments, size_t count);
+
   /// @brief add a segment to the path.
   void addSegment(Segment s);
 
@@ -84,19 +95,31 @@ public:
   // ===== drawing functions =====
 
   /// @brief transform and draw the widget
+  /// The transformed path is kept and only re-calculated when the path or the transformation has changed.
   /// @param cbDraw Pixel drawing callback function
   void draw(gfxDraw::fDrawPixel cbDraw);
 
-  // outer dimension of last drawn Widget
+  /// @brief Keep the drawn pixels as horizontal spans to redraw an unchanged widget without tracing and filling the path.
+  /// This uses more memory and is useful for widgets that are redrawn often.
+  /// @param enable true to enable the span cache.
+  void setSpanCache(bool enable);
+
+  // outer dimension of last drawn Widget from the bounding box of the path and the clip rectangle.
+  // The values are INT16_MAX / INT16_MIN when the widget was not visible.
   int16_t x_min;
   int16_t y_min;
   int16_t x_max;
   int16_t y_max;
 
 protected:
+  /// @brief segments of the path when not set from an external array.
   std::vector<gfxDraw::Segment> _segments;
 
 private:
+  /// @brief external array of segments from setPath, used instead of _segments when not null.
+  const gfxDraw::Segment *_arraySegments = nullptr;
+  size_t _arrayCount = 0;
+
   // combined transformation matrix
   Matrix1000 _matrix;
 
@@ -109,11 +132,51 @@ private:
   /// @param m2 Matrix2
   void _multiplyMatrix(Matrix1000 &m1, Matrix1000 &m2);
 
-  void _extendBox(int16_t x, int16_t y);
+  /// @brief version of the path, changed by setPath and addSegment.
+  uint32_t _pathVersion = 1;
+
+  // ===== cache of the transformed path =====
+
+  /// @brief transformed segments
+  std::vector<gfxDraw::Segment> _tSegments;
+
+  /// @brief transformation matrix used for the transformed segments
+  Matrix1000 _tMatrix;
+
+  /// @brief path version used for the transformed segments, 0 = not transformed.
+  uint32_t _tVersion = 0;
+
+  /// @brief transformed stroke width.
+  int16_t _tStrokeWidth = 1;
+
+  /// @brief bounding box of the transformed segments including the stroke.
+  BoundingBox _tBox;
+
+  /// @brief A horizontal sequence of drawn pixels.
+  struct _CacheSpan {
+    int16_t x0;
+    int16_t x1;
+    int16_t y;
+    bool isBorder;
+  };
+
+  bool _spanCache = false;
+
+  /// @brief the drawn spans in drawing order.
+  std::vector<_CacheSpan> _spans;
+
+  /// @brief the drawing mode used for the spans, -1 = no valid spans.
+  int8_t _spansMode = -1;
+
+  /// @brief add a pixel sequence to the span cache
+  void _addSpan(int16_t x0, int16_t x1, int16_t y, bool isBorder);
 
   // Stroke coloring
   gfxDraw::ARGB _stroke;
 
+  int16_t _strokeWidth = 1;
+  StrokeFlags _strokeFlags = StrokeFlags::ButtCap;
+
   /// @brief used for solid filling and gradient start color.
   gfxDraw::ARGB _fillColor1;
 
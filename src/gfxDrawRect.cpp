@@ -42,7 +42,27 @@ void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, fSetPixel cbBorder, fS
   // draw the border in fill color
   if (!cbBorder) { cbBorder = cbFill; }
 
-  if ((cbBorder) && (w != 0) && (h != 0)) {
+  if (cbFill) {
+    drawRect(x, y, w, h, cbBorder, [&](int16_t sx, int16_t ex, int16_t sy) {
+      while (sx <= ex) cbFill(sx++, sy);
+    });
+  } else {
+    drawRect(x, y, w, h, cbBorder, fDrawSpan(nullptr));
+  }
+}  // drawRect()
+
+
+/// @brief Draw a rectangle with border and fill callbacks, the inner pixels are passed as horizontal spans.
+void drawRect(Point pos, int16_t w, int16_t h, fSetPixel cbBorder, fDrawSpan cbFill) {
+  drawRect(pos.x, pos.y, w, h, cbBorder, cbFill);
+};
+
+
+/// @brief Draw a rectangle with border and fill callbacks, the inner pixels are passed as horizontal spans.
+void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, fSetPixel cbBorder, fDrawSpan cbFill) {
+  GFXDRAW_STATS_SCOPE(statsScope);
+
+  if ((cbBorder || cbFill) && (w != 0) && (h != 0)) {
 
     // ensure w >= 0
     if (w < 0) {
@@ -56,24 +76,49 @@ void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, fSetPixel cbBorder, fS
       y = y - h + 1;
     }
 
-
     int16_t endX = x + w - 1;
     int16_t endY = y + h - 1;
 
-    // draw lowest line
-    for (int16_t nx = x; nx <= endX; nx++) cbBorder(nx, y);
+    // only the lines and columns inside the clip rectangle are drawn.
+    const ClipRect &clip = _clipRect;
+    if (!clip.intersects(x, y, endX, endY)) return;
+    int16_t fromY = (y < clip.y0) ? clip.y0 : y;
+    int16_t toY = (endY > clip.y1) ? clip.y1 : endY;
+    int16_t fromX = (x < clip.x0) ? clip.x0 : x;
+    int16_t toX = (endX > clip.x1) ? clip.x1 : endX;
+
+    if (!cbBorder) {
+      // draw the border in fill color, so all lines are complete spans.
+      GFXDRAW_STAT(fillPixels, (toY - fromY + 1) * (toX - fromX + 1));
+      for (int16_t ny = fromY; ny <= toY; ny++) cbFill(fromX, toX, ny);
+
+    } else {
+      int16_t fillX0 = (fromX > x) ? fromX : x + 1;
+      int16_t fillX1 = (toX < endX) ? toX : endX - 1;
+
+      for (int16_t ny = fromY; ny <= toY; ny++) {
+        if ((ny == y) || (ny == endY)) {
+          // draw lowest and highest line
+          GFXDRAW_STAT(borderPixels, toX - fromX + 1);
+          for (int16_t nx = fromX; nx <= toX; nx++) cbBorder(nx, ny);
 
-    // draw first point, fill color and last point
-    for (int16_t ny = y + 1; ny < endY; ny++) {
-      cbBorder(x, ny);
-      if (cbFill) {
-        for (int16_t nx = x + 1; nx < endX; nx++) cbFill(nx, ny);
+        } else {
+          // draw first point, fill span and last point
+          if (x >= clip.x0) {
+            GFXDRAW_STAT(borderPixels, 1);
+            cbBorder(x, ny);
+          }
+          if ((cbFill) && (fillX0 <= fillX1)) {
+            GFXDRAW_STAT(fillPixels, fillX1 - fillX0 + 1);
+            cbFill(fillX0, fillX1, ny);
+          }
+          if (endX <= clip.x1) {
+            GFXDRAW_STAT(borderPixels, 1);
+            cbBorder(endX, ny);
+          }
+        }
       }
-      cbBorder(endX, ny);
     }
-
-    // draw highest line
-    for (int16_t nx = x; nx <= endX; nx++) cbBorder(nx, endY);
   }
 }  // drawRect()
 
@@ -91,7 +136,28 @@ void drawRoundedRect(int16_t x0, int16_t y0, int16_t w, int16_t h, int16_t radiu
   // draw the border in fill color
   if (!cbBorder) { cbBorder = cbFill; }
 
-  if ((cbBorder) && (w != 0) && (h != 0)) {
+  if (cbFill) {
+    drawRoundedRect(x0, y0, w, h, radius, cbBorder, [&](int16_t sx, int16_t ex, int16_t sy) {
+      while (sx <= ex) cbFill(sx++, sy);
+    });
+  } else {
+    drawRoundedRect(x0, y0, w, h, radius, cbBorder, fDrawSpan(nullptr));
+  }
+}  // drawRoundedRect()
+
+
+/// @brief Draw a rounded rectangle with border and fill callbacks, the inner pixels are passed as horizontal spans.
+/// @param x0 Starting Point X coordinate.
+/// @param y0 Starting Point Y coordinate.
+/// @param w width of the rect in pixels
+/// @param h height of the rect in pixels
+/// @param radius corner radius
+/// @param cbBorder Callback with coordinates of rect border pixels.
+/// @param cbFill Callback with horizontal sequences of rect fill pixels.
+void drawRoundedRect(int16_t x0, int16_t y0, int16_t w, int16_t h, int16_t radius, fSetPixel cbBorder, fDrawSpan cbFill) {
+  GFXDRAW_STATS_SCOPE(statsScope);
+
+  if ((cbBorder || cbFill) && (w != 0) && (h != 0)) {
     // ensure w > 0
     if (w < 0) {
       w = -w;
@@ -112,32 +178,53 @@ void drawRoundedRect(int16_t x0, int16_t y0, int16_t w, int16_t h, int16_t radiu
     int16_t endY = y0 + h - 1;
     int16_t oldY = y0 - 1;  // cy = current y line, start with
 
+    const ClipRect clip = _clipRect;
+    if (!clip.intersects(x0, y0, endX, endY)) return;
+
+    // restrict the pixels and spans to the clip rectangle when the rectangle is not completely inside.
+    bool clipped = !clip.covers(x0, y0, endX, endY);
+
+    auto border = [&](int16_t x, int16_t y) {
+      if ((clipped) && (!clip.contains(x, y))) return;
+      GFXDRAW_STAT(borderPixels, 1);
+      if (cbBorder) {
+        cbBorder(x, y);
+      } else {
+        // draw the border in fill color
+        cbFill(x, x, y);
+      }
+    };
+    auto fill = [&](int16_t sx, int16_t ex, int16_t sy) {
+      if ((clipped) && (!clip.clipSpan(sx, ex, sy))) return;
+      GFXDRAW_STAT(fillPixels, ex - sx + 1);
+      cbFill(sx, ex, sy);
+    };
+
     // draw upper part: rounded start corner, fill between the corner, rounded end-corner
     drawCircleQuadrant(radius, 0, [&](int16_t x, int16_t y) {
       int16_t cx = x0 + radius - y;
       int16_t cy = y0 + radius - x;
+      int16_t ex = endX - radius + y;
 
-      cbBorder(cx, cy);
+      border(cx, cy);
       if (cy != oldY) {
         cx++;
         if (cy == y0) {
-          while (cx < endX - radius + y) cbBorder(cx++, cy);
-        } else {
-          while (cx < endX - radius + y) cbFill(cx++, cy);
+          while (cx < ex) border(cx++, cy);
+        } else if ((cbFill) && (cx < ex)) {
+          fill(cx, ex - 1, cy);
         }
         oldY = cy;
       }
-      cbBorder(endX - radius + y, cy);
+      border(ex, cy);
     });
 
     oldY++;
-    // draw first point, fill color and last point
+    // draw first point, fill span and last point
     while (oldY <= endY - radius) {
-      cbBorder(x0, oldY);
-      if (cbFill) {
-        for (int16_t x = x0 + 1; x < endX; x++) cbFill(x, oldY);
-      }
-      cbBorder(endX, oldY);
+      border(x0, oldY);
+      if ((cbFill) && (x0 + 1 < endX)) fill(x0 + 1, endX - 1, oldY);
+      border(endX, oldY);
       oldY++;
     }
 
@@ -145,18 +232,19 @@ void drawRoundedRect(int16_t x0, int16_t y0, int16_t w, int16_t h, int16_t radiu
     drawCircleQuadrant(radius, 0, [&](int16_t x, int16_t y) {
       int16_t cx = x0 + radius - y;
       int16_t cy = endY - radius + x;
+      int16_t ex = endX - radius + y;
 
-      cbBorder(cx, cy);
+      border(cx, cy);
       if (cy != oldY) {
         cx++;
         if (cy == endY) {
-          while (cx < endX - radius + y) cbBorder(cx++, cy);
-        } else {
-          while (cx < endX - radius + y) cbFill(cx++, cy);
+          while (cx < ex) border(cx++, cy);
+        } else if ((cbFill) && (cx < ex)) {
+          fill(cx, ex - 1, cy);
         }
         oldY = cy;
       }
-      cbBorder(endX - radius + y, cy);
+      border(ex, cy);
     });
   }
 }  // drawRoundedRect()
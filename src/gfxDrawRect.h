@@ -57,6 +57,38 @@ void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, fSetPixel cbBorder = n
 void drawRoundedRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t radius, fSetPixel cbBorder = nullptr, fSetPixel cbFill = nullptr);
 
 
+/// ===== Draw functions with span callback for filling =====
+
+/// @brief Draw a rectangle with border and fill callbacks, the inner pixels are passed as horizontal spans.
+/// @param pos Starting Point.
+/// @param w width of the rect in pixels
+/// @param h height of the rect in pixels
+/// @param cbBorder Callback with coordinates of rect border pixels. cbFill is used when cbBorder is null.
+/// @param cbFill Callback with horizontal sequences of rect fill pixels.
+void drawRect(Point pos, int16_t w, int16_t h, fSetPixel cbBorder, fDrawSpan cbFill);
+
+
+/// @brief Draw a rectangle with border and fill callbacks, the inner pixels are passed as horizontal spans.
+/// @param x Starting Point X coordinate.
+/// @param y Starting Point Y coordinate.
+/// @param w width of the rect in pixels
+/// @param h height of the rect in pixels
+/// @param cbBorder Callback with coordinates of rect border pixels. cbFill is used when cbBorder is null.
+/// @param cbFill Callback with horizontal sequences of rect fill pixels.
+void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, fSetPixel cbBorder, fDrawSpan cbFill);
+
+
+/// @brief Draw a rounded rectangle with border and fill callbacks, the inner pixels are passed as horizontal spans.
+/// @param x0 Starting Point X coordinate.
+/// @param y0 Starting Point Y coordinate.
+/// @param w width of the rect in pixels
+/// @param h height of the rect in pixels
+/// @param radius corner radius
+/// @param cbBorder Callback with coordinates of rect border pixels. cbFill is used when cbBorder is null.
+/// @param cbFill Callback with horizontal sequences of rect fill pixels.
+void drawRoundedRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t radius, fSetPixel cbBorder, fDrawSpan cbFill);
+
+
 }  // gfxDraw:: namespace
 
 
@@ -12,80 +12,502 @@
 #include "gfxDraw.h"
 #include "gfxDrawSprite.h"
 
+#include <memory>
+#include <type_traits>
+
 #ifndef GFX_TRACE
 #define GFX_TRACE(...)  // GFXDRAWTRACE(__VA_ARGS__)
 #endif
 
 namespace gfxDraw {
 
-Sprite::Sprite() {
+// ===== Pixel formats =====
+
+// Find the color in the palette or add it.
+PixelIndexed8::Pixel PixelIndexed8::fromARGB(ARGB color) {
+  if (color.Alpha == 0) return (0);
+
+  if ((_lastIndex > 0) && (_lastIndex < palette.size()) && (palette[_lastIndex].raw == color.raw)) {
+    return (_lastIndex);
+  }
+
+  for (size_t n = 1; n < palette.size(); n++) {
+    if (palette[n].raw == color.raw) {
+      _lastIndex = n;
+      return (_lastIndex);
+    }
+  }
+
+  if (palette.size() < 256) {
+    palette.push_back(color);
+    _lastIndex = palette.size() - 1;
+    return (_lastIndex);
+  }
+
+  // all colors are used, take the nearest one.
+  uint32_t minDist = UINT32_MAX;
+  Pixel minIndex = 1;
+  for (size_t n = 1; n < palette.size(); n++) {
+    int32_t da = palette[n].Alpha - color.Alpha;
+    int32_t dr = palette[n].Red - color.Red;
+    int32_t dg = palette[n].Green - color.Green;
+    int32_t db = palette[n].Blue - color.Blue;
+    uint32_t dist = (da * da) + (dr * dr) + (dg * dg) + (db * db);
+    if (dist < minDist) {
+      minDist = dist;
+      minIndex = n;
+    }
+  }
+  return (minIndex);
+}  // fromARGB()
+
+
+bool PixelIndexed8::findIndex(ARGB color, Pixel &p) const {
+  if (color.Alpha == 0) {
+    p = 0;
+    return (true);
+  }
+
+  for (size_t n = 1; n < palette.size(); n++) {
+    if (palette[n].raw == color.raw) {
+      p = n;
+      return (true);
+    }
+  }
+  return (false);
+}  // findIndex()
+
+
+bool PixelIndexed8::sameColors(const PixelIndexed8 &other) const {
+  size_t count = (palette.size() < other.palette.size()) ? palette.size() : other.palette.size();
+  for (size_t n = 0; n < count; n++) {
+    if (palette[n].raw != other.palette[n].raw) return (false);
+  }
+  return (true);
+}  // sameColors()
+
+
+// ===== Sprite =====
+
+template <class FORMAT>
+SpriteT<FORMAT>::SpriteT() {
   _x = _y = _w = _h = 0;
 }
 
-Sprite::Sprite(int16_t x, int16_t y, int16_t w, int16_t h)
+template <class FORMAT>
+SpriteT<FORMAT>::SpriteT(int16_t x, int16_t y, int16_t w, int16_t h)
   : _x(x), _y(y), _w(w), _h(h) {
   // allocate data memory
-  data.resize(_w * _h);  // initialized with 0, all pixels with Alpha 0
+  data.resize(_w * _h, FORMAT::transparent());
 };
 
-void Sprite::drawPixel(int16_t x, int16_t y, ARGB color) {
+template <class FORMAT>
+void SpriteT<FORMAT>::drawPixel(int16_t x, int16_t y, ARGB color) {
   // GFX_TRACE("bg::set(%d,%d)=%08x", x, y, color.raw);
+  _drawPixel(x, y, _format.fromARGB(color));
+}  // drawPixel
+
+
+template <class FORMAT>
+void SpriteT<FORMAT>::_drawPixel(int16_t x, int16_t y, Pixel p) {
 
   if (_w == 0) {
     _createData(x, y);
     GFX_TRACE(" init to (%d/%d)-(%d/%d)", _x, _y, _x + _w - 1, _y + _h - 1);
   }
 
-  if (x < _x) {
-    _insertLeft(_x - x);
+  if (isCompact()) _expand();
+
+  if ((x < _x) || (x >= _x + _w) || (y < _y) || (y >= _y + _h)) {
+    _extend(x, y);
     GFX_TRACE(" resize to (%d/%d)-(%d/%d)", _x, _y, _x + _w - 1, _y + _h - 1);
 
-  } else if (x >= _x + _w) {
-    _insertRight(x - (_x + _w) + 1);
-    GFX_TRACE(" resize to (%d/%d)-(%d/%d)\n", _x, _y, _x + _w - 1, _y + _h - 1);
+    // pixels too far away from the existing data for a size up to INT16_MAX are not stored.
+    if ((x < _x) || (x >= _x + _w) || (y < _y) || (y >= _y + _h)) return;
   }
 
-  if (y < _y) {
-    _insertTop(_y - y);
-    GFX_TRACE(" resize to (%d/%d)-(%d/%d)", _x, _y, _x + _w - 1, _y + _h - 1);
+  data[(x - _x) + (y - _y) * _w] = p;  // save the background color
+}  // _drawPixel
 
-  } else if (y >= _y + _h) {
-    _insertBottom(y - (_y + _h) + 1);
-    GFX_TRACE(" resize to (%d/%d)-(%d/%d)", _x, _y, _x + _w - 1, _y + _h - 1);
-  }
 
-  ARGB *cell = &data[(x - _x) + (y - _y) * _w];
-  *cell = color;  // save the background color
-}  // drawPixel
+template <class FORMAT>
+void SpriteT<FORMAT>::reserve(int16_t x, int16_t y, int16_t w, int16_t h) {
+  GFX_TRACE("Sprite::reserve(%d/%d %d*%d)", x, y, w, h);
+  if ((w <= 0) || (h <= 0)) return;
+  if (isCompact()) _expand();
+
+  if (_w == 0) {
+    _resize(x, y, w, h);
+
+  } else {
+    // include the current pixels
+    int32_t x0 = (x < _x) ? x : _x;
+    int32_t y0 = (y < _y) ? y : _y;
+    int32_t x1 = (x + w > _x + _w) ? x + w : _x + _w;
+    int32_t y1 = (y + h > _y + _h) ? y + h : _y + _h;
+    if ((x1 - x0 > INT16_MAX) || (y1 - y0 > INT16_MAX)) return;
+    if ((x0 < _x) || (y0 < _y) || (x1 > _x + _w) || (y1 > _y + _h)) {
+      _resize(x0, y0, x1 - x0, y1 - y0);
+    }
+  }
+}  // reserve()
 
 
-void Sprite::draw(Point pos, fDrawPixel cbDraw) {
-  GFX_TRACE("Sprite::draw()");
+template <class FORMAT>
+template <class TDraw>
+void SpriteT<FORMAT>::_draw(Point pos, TDraw cbDraw) {
   int16_t xPos = _x + pos.x;
   int16_t yPos = _y + pos.y;
 
+  if (isCompact()) {
+    // only the pixels of the runs are visited.
+    size_t n = 0;
+    for (int16_t y = 0; y < _h; y++) {
+      for (uint32_t r = _rowRuns[y]; r < _rowRuns[y + 1]; r++) {
+        int16_t x = xPos + _runs[r].x;
+        for (int16_t len = _runs[r].len; len > 0; len--) {
+          Pixel p = data[n++];
+          if (FORMAT::isVisible(p)) {
+            cbDraw(x, yPos + y, p);
+          }
+          x++;
+        }
+      }
+    }
+    return;
+  }
+
   for (int16_t y = 0; y < _h; y++) {
     uint32_t rowOffset = (y * _w);
     for (int16_t x = 0; x < _w; x++) {
-      ARGB col = data[rowOffset++];
-      if (col.Alpha > 0) {
-        cbDraw(xPos + x, yPos + y, col);
+      Pixel p = data[rowOffset++];
+      if (FORMAT::isVisible(p)) {
+        cbDraw(xPos + x, yPos + y, p);
       }
     }
   }
+}  // _draw()
+
+
+template <class FORMAT>
+void SpriteT<FORMAT>::draw(Point pos, fDrawPixel cbDraw) {
+  GFX_TRACE("Sprite::draw()");
+  GFXDRAW_STATS_SCOPE(statsScope);
+  _draw(pos, [&](int16_t x, int16_t y, Pixel p) {
+    cbDraw(x, y, _format.toARGB(p));
+  });
 }  // draw()
 
 
+template <class FORMAT>
+void SpriteT<FORMAT>::drawNative(Point pos, fDrawNative cbDraw) {
+  GFX_TRACE("Sprite::drawNative()");
+  GFXDRAW_STATS_SCOPE(statsScope);
+  _draw(pos, cbDraw);
+}  // drawNative()
+
+
+template <class FORMAT>
+template <class TRun>
+void SpriteT<FORMAT>::_drawRuns(Point pos, TRun cbRun) {
+  const ClipRect clip = _clipRect;
+  int16_t xPos = _x + pos.x;
+  int16_t yPos = _y + pos.y;
+
+  // find the sequences of visible pixels from the data index n on and clip them.
+  auto scan = [&](int16_t x, size_t n, int16_t len, int16_t yDraw) {
+    int16_t end = x + len;
+    while (x < end) {
+      if (!FORMAT::isVisible(data[n])) {
+        x++;
+        n++;
+      } else {
+        int16_t start = x;
+        size_t startIndex = n;
+        while ((x < end) && FORMAT::isVisible(data[n])) {
+          x++;
+          n++;
+        }
+        int16_t left = xPos + start;
+        int16_t right = xPos + x - 1;
+        if (clip.clipSpan(left, right, yDraw)) {
+          cbRun(left, yDraw, startIndex + (left - xPos - start), right - left + 1);
+        }
+      }
+    }
+  };
+
+  size_t n = 0;
+  for (int16_t y = 0; y < _h; y++) {
+    int16_t yDraw = yPos + y;
+
+    if (isCompact()) {
+      for (uint32_t r = _rowRuns[y]; r < _rowRuns[y + 1]; r++) {
+        if ((yDraw >= clip.y0) && (yDraw <= clip.y1)) scan(_runs[r].x, n, _runs[r].len, yDraw);
+        n += _runs[r].len;
+      }
+
+    } else if ((yDraw >= clip.y0) && (yDraw <= clip.y1)) {
+      scan(0, (size_t)y * _w, _w, yDraw);
+    }
+  }
+}  // _drawRuns()
+
+
+template <class FORMAT>
+void SpriteT<FORMAT>::drawRows(Point pos, fDrawRow cbRow) {
+  GFX_TRACE("Sprite::drawRows()");
+  GFXDRAW_STATS_SCOPE(statsScope);
+
+  if constexpr (std::is_same<Pixel, ARGB>::value) {
+    // the stored pixels are passed directly.
+    _drawRuns(pos, [&](int16_t x, int16_t y, size_t n, int16_t len) {
+      cbRow(x, y, &data[n], len);
+    });
+
+  } else {
+    std::vector<ARGB> row(_w);
+    _drawRuns(pos, [&](int16_t x, int16_t y, size_t n, int16_t len) {
+      for (int16_t i = 0; i < len; i++) row[i] = _format.toARGB(data[n + i]);
+      cbRow(x, y, row.data(), len);
+    });
+  }
+}  // drawRows()
+
+
+template <class FORMAT>
+void SpriteT<FORMAT>::drawNativeRows(Point pos, fDrawNativeRow cbRow) {
+  GFX_TRACE("Sprite::drawNativeRows()");
+  GFXDRAW_STATS_SCOPE(statsScope);
+
+  if constexpr (std::is_same<Pixel, bool>::value) {
+    // the bits of a std::vector<bool> can't be passed by a pointer.
+    std::unique_ptr<Pixel[]> row(new Pixel[_w]);
+    _drawRuns(pos, [&](int16_t x, int16_t y, size_t n, int16_t len) {
+      for (int16_t i = 0; i < len; i++) row[i] = data[n + i];
+      cbRow(x, y, row.get(), len);
+    });
+
+  } else {
+    _drawRuns(pos, [&](int16_t x, int16_t y, size_t n, int16_t len) {
+      cbRow(x, y, &data[n], len);
+    });
+  }
+}  // drawNativeRows()
+
+
+template <class FORMAT>
+void SpriteT<FORMAT>::_readRow(int16_t y, int16_t x0, int32_t w, Pixel *buf, size_t &n) const {
+  std::fill(buf, buf + w, FORMAT::transparent());
+  if ((y < _y) || (y >= _y + _h)) return;
+
+  int16_t ly = y - _y;
+  if (isCompact()) {
+    for (uint32_t r = _rowRuns[ly]; r < _rowRuns[ly + 1]; r++) {
+      std::copy(data.begin() + n, data.begin() + n + _runs[r].len, buf + (_x + _runs[r].x - x0));
+      n += _runs[r].len;
+    }
+
+  } else {
+    auto row = data.begin() + (size_t)ly * _w;
+    std::copy(row, row + _w, buf + (_x - x0));
+  }
+}  // _readRow()
+
+
+template <class FORMAT>
+template <class TRow>
+void SpriteT<FORMAT>::_diffRows(const SpriteT &previous, TRow cbRow) const {
+  // the area of both Sprites
+  int32_t x0 = INT16_MAX, y0 = INT16_MAX;
+  int32_t x1 = INT16_MIN, y1 = INT16_MIN;  // first pixel right and below
+
+  for (const SpriteT *s : { this, &previous }) {
+    if (s->_w > 0) {
+      if (s->_x < x0) x0 = s->_x;
+      if (s->_y < y0) y0 = s->_y;
+      if (s->_x + s->_w > x1) x1 = s->_x + s->_w;
+      if (s->_y + s->_h > y1) y1 = s->_y + s->_h;
+    }
+  }
+  if (x0 >= x1) return;
+
+  int32_t w = x1 - x0;
+  std::unique_ptr<Pixel[]> cur(new Pixel[w]);
+  std::unique_ptr<Pixel[]> prev(new Pixel[w]);
+  size_t n = 0;
+  size_t prevN = 0;
+
+  // transparent pixels are equal in any color, pixels of Sprites with other colors are compared as ARGB.
+  bool sameColors = _format.sameColors(previous._format);
+  auto changed = [&](int32_t i) -> bool {
+    bool visible = FORMAT::isVisible(cur[i]);
+    if (visible != FORMAT::isVisible(prev[i])) return (true);
+    if (!visible) return (false);
+    if (sameColors) return (!(cur[i] == prev[i]));
+    return (_format.toARGB(cur[i]).raw != previous._format.toARGB(prev[i]).raw);
+  };
+
+  for (int32_t y = y0; y < y1; y++) {
+    _readRow(y, x0, w, cur.get(), n);
+    previous._readRow(y, x0, w, prev.get(), prevN);
+    cbRow(y, x0, w, cur.get(), changed);
+  }
+}  // _diffRows()
+
+
+template <class FORMAT>
+std::vector<BoundingBox> SpriteT<FORMAT>::dirtyRects(const SpriteT &previous) const {
+  GFX_TRACE("Sprite::dirtyRects()");
+  std::vector<BoundingBox> rects;
+
+  // the rectangles that can be extended by the next row with the number of changed pixels in the rows.
+  struct _Open {
+    BoundingBox box;
+    int64_t pixels;
+  };
+  std::vector<_Open> open;
+
+  // add a sequence of changed pixels to a rectangle when at least half of the pixels stay changed.
+  auto addSpan = [&](int16_t left, int16_t right, int16_t y) {
+    int64_t len = right - left + 1;
+    for (_Open &o : open) {
+      if ((left <= o.box.x1 + GFXDRAW_DIRTY_GAP + 1) && (right >= o.box.x0 - GFXDRAW_DIRTY_GAP - 1)) {
+        int16_t l = (left < o.box.x0) ? left : o.box.x0;
+        int16_t r = (right > o.box.x1) ? right : o.box.x1;
+        int64_t area = (int64_t)(r - l + 1) * (y - o.box.y0 + 1);
+        if (area <= 2 * (o.pixels + len)) {
+          o.box.x0 = l;
+          o.box.x1 = r;
+          o.box.y1 = y;
+          o.pixels += len;
+          return;
+        }
+      }
+    }
+    _Open o;
+    o.box.x0 = left;
+    o.box.y0 = y;
+    o.box.x1 = right;
+    o.box.y1 = y;
+    o.pixels = len;
+    open.push_back(o);
+  };
+
+  _diffRows(previous, [&](int16_t y, int16_t x0, int32_t w, Pixel *, auto &changed) {
+    // the rectangles without changes on the last row are complete.
+    for (size_t i = 0; i < open.size();) {
+      if (open[i].box.y1 < y - 1) {
+        rects.push_back(open[i].box);
+        open[i] = open.back();
+        open.pop_back();
+      } else {
+        i++;
+      }
+    }
+
+    int32_t i = 0;
+    while (i < w) {
+      if (!changed(i)) {
+        i++;
+      } else {
+        // combine changed pixels with small gaps.
+        int32_t start = i;
+        int32_t last = i++;
+        while ((i < w) && (i - last <= GFXDRAW_DIRTY_GAP + 1)) {
+          if (changed(i)) last = i;
+          i++;
+        }
+        addSpan(x0 + start, x0 + last, y);
+      }
+    }
+  });
+
+  for (_Open &o : open) rects.push_back(o.box);
+  return (rects);
+}  // dirtyRects()
+
+
+template <class FORMAT>
+void SpriteT<FORMAT>::diff(const SpriteT &previous, SpriteT &changes, ARGB erase) const {
+  GFX_TRACE("Sprite::diff()");
+  changes = SpriteT();
+  changes._format = _format;  // e.g. the palette
+  Pixel erasePixel = changes._format.fromARGB(erase);
+
+  _diffRows(previous, [&](int16_t y, int16_t x0, int32_t w, Pixel *cur, auto &changed) {
+    for (int32_t i = 0; i < w; i++) {
+      if (changed(i)) {
+        Pixel p = FORMAT::isVisible(cur[i]) ? cur[i] : erasePixel;
+        if (FORMAT::isVisible(p)) changes._drawPixel(x0 + i, y, p);
+      }
+    }
+  });
+}  // diff()
+
+
+template <class FORMAT>
+void SpriteT<FORMAT>::compact() {
+  GFX_TRACE("Sprite::compact()");
+  if (isCompact() || (_w == 0)) return;
+
+  std::vector<Pixel> runData;
+  _rowRuns.reserve(_h + 1);
+
+  for (int16_t y = 0; y < _h; y++) {
+    auto row = data.begin() + (size_t)y * _w;
+    _rowRuns.push_back(_runs.size());
+
+    int16_t x = 0;
+    while (x < _w) {
+      if (!FORMAT::isVisible(row[x])) {
+        x++;
+      } else {
+        int16_t start = x;
+        while ((x < _w) && FORMAT::isVisible(row[x])) x++;
+        _runs.push_back({ start, (int16_t)(x - start) });
+        runData.insert(runData.end(), row + start, row + x);
+      }
+    }
+  }
+  _rowRuns.push_back(_runs.size());
+
+  _runs.shrink_to_fit();
+  runData.shrink_to_fit();
+  data.swap(runData);
+}  // compact()
+
+
+template <class FORMAT>
+size_t SpriteT<FORMAT>::memorySize() const {
+  return (((data.capacity() * FORMAT::bitsPerPixel + 7) / 8) + (_runs.capacity() * sizeof(_Run))
+          + (_rowRuns.capacity() * sizeof(uint32_t)) + _format.memorySize());
+}  // memorySize()
+
 
-void Sprite::mapColor(fMapColor cbMap, bool mapAll) {
+
+template <class FORMAT>
+void SpriteT<FORMAT>::mapColor(fMapColor cbMap, bool mapAll) {
   GFX_TRACE("Sprite::map()");
 
+  if (isCompact()) {
+    if (!mapAll) {
+      // the runs contain the non-transparent pixels only.
+      for (size_t n = 0; n < data.size(); n++) {
+        Pixel p = data[n];
+        if (FORMAT::isVisible(p)) data[n] = _format.fromARGB(cbMap(_format.toARGB(p)));
+      }
+      return;
+    }
+    _expand();
+  }
+
   for (int16_t y = 0; y < _h; y++) {
     uint32_t rowOffset = (y * _w);
     for (int16_t x = 0; x < _w; x++) {
-      ARGB color = data[rowOffset];
-      if (mapAll || (color.Alpha > 0)) {
-        data[rowOffset] = cbMap(color);
+      Pixel p = data[rowOffset];
+      if (mapAll || FORMAT::isVisible(p)) {
+        data[rowOffset] = _format.fromARGB(cbMap(_format.toARGB(p)));
       }
       rowOffset++;
     }
@@ -93,15 +515,42 @@ void Sprite::mapColor(fMapColor cbMap, bool mapAll) {
 }  // draw()
 
 
-void Sprite::mapColor(ARGB oldColor, ARGB newColor) {
+template <class FORMAT>
+void SpriteT<FORMAT>::mapColor(ARGB oldColor, ARGB newColor) {
   GFX_TRACE("Sprite::mapColor()");
+  // compare the pixels in the format of the Sprite.
+  Pixel oldPixel;
+
+  if constexpr (std::is_same<FORMAT, PixelIndexed8>::value) {
+    // fromARGB would add the old color to the palette or return the nearest color of a full palette.
+    if (!_format.findIndex(oldColor, oldPixel)) return;
+
+    Pixel p;
+    if ((oldPixel != 0) && (newColor.Alpha > 0) && (!_format.findIndex(newColor, p))) {
+      // the new color is not in the palette yet so changing the palette entry changes all pixels.
+      _format.palette[oldPixel] = newColor;
+      return;
+    }
+  } else {
+    oldPixel = _format.fromARGB(oldColor);
+  }
+  Pixel newPixel = _format.fromARGB(newColor);
+
+  if (isCompact()) {
+    if (FORMAT::isVisible(oldPixel)) {
+      for (size_t n = 0; n < data.size(); n++) {
+        if (data[n] == oldPixel) data[n] = newPixel;
+      }
+      return;
+    }
+    _expand();
+  }
 
   for (int16_t y = 0; y < _h; y++) {
     uint32_t rowOffset = (y * _w);
     for (int16_t x = 0; x < _w; x++) {
-      ARGB color = data[rowOffset];
-      if (color == oldColor) {
-        data[rowOffset] = newColor;
+      if (data[rowOffset] == oldPixel) {
+        data[rowOffset] = newPixel;
       }
       rowOffset++;
     }
@@ -136,90 +585,132 @@ void Sprite::mapColor(ARGB oldColor, ARGB newColor) {
 // }  // markOld();
 
 // first initializing the data
-void Sprite::_createData(int16_t x, int16_t y) {
+template <class FORMAT>
+void SpriteT<FORMAT>::_createData(int16_t x, int16_t y) {
   // first initialization.
   _x = x & 0xFFF0;
   _y = y;
   _w = 16;
   _h = 16;
-  data.resize(16 * 16);  // initialized with 0, all pixels with Alpha 0
+  data.resize(16 * 16, FORMAT::transparent());
 };
 
 
-// resize the array based 0/0
-void Sprite::_insertTop(uint16_t count) {
-  ARGB blank;
+// The headroom for a side that grows, a multiple of 16 pixels.
+static int32_t _growSize(int32_t count, int32_t size) {
+  int32_t headroom = (size * GFXDRAW_SPRITE_HEADROOM) / 100;
+  if (count < headroom) count = headroom;
+  return ((count + 15) & ~15);
+}  // _growSize()
+
+
+// Extend the data to include the pixel at x/y.
+// The sides that need to grow get a headroom relative to the current size so a Sprite that is growing pixel by pixel
+// in any direction is only reallocated a few times.
+template <class FORMAT>
+void SpriteT<FORMAT>::_extend(int16_t x, int16_t y) {
+  int32_t x0 = _x;
+  int32_t y0 = _y;
+  int32_t x1 = _x + _w;  // first pixel right of the data
+  int32_t y1 = _y + _h;  // first line below the data
+
+  if (x < x0) {
+    x0 -= _growSize(x0 - x, _w);
+  } else if (x >= x1) {
+    x1 += _growSize(x - x1 + 1, _w);
+  }
 
-  // expand by multiple of 16
-  count = (count + 15) & 0xFFF0;
-  int16_t y2 = _y - count;
-  int16_t h2 = _h + count;
+  if (y < y0) {
+    y0 -= _growSize(y0 - y, _h);
+  } else if (y >= y1) {
+    y1 += _growSize(y - y1 + 1, _h);
+  }
 
-  GFX_TRACE(" t-expand %d -> %d", _h, h2);
-  data.reserve(_w * h2);  // alloc at once.
+  // stay in the coordinate range, x1 and y1 are excluding so a pixel at INT16_MAX is included.
+  if (x0 < INT16_MIN) x0 = INT16_MIN;
+  if (y0 < INT16_MIN) y0 = INT16_MIN;
+  if (x1 > INT16_MAX + 1) x1 = INT16_MAX + 1;
+  if (y1 > INT16_MAX + 1) y1 = INT16_MAX + 1;
+
+  // the width and height are limited to INT16_MAX, the headroom is reduced on the side that grows.
+  if (x1 - x0 > INT16_MAX) {
+    if (x < _x) {
+      x0 = x1 - INT16_MAX;
+    } else {
+      x1 = x0 + INT16_MAX;
+    }
+  }
+  if (y1 - y0 > INT16_MAX) {
+    if (y < _y) {
+      y0 = y1 - INT16_MAX;
+    } else {
+      y1 = y0 + INT16_MAX;
+    }
+  }
 
-  // insert blanks on top
-  data.insert(data.begin(), count * _w, blank);
+  // the pixel cannot be included
+  if ((x < x0) || (x >= x1) || (y < y0) || (y >= y1)) return;
 
-  _y = y2;
-  _h = h2;
-}  // _insertTop()
+  _resize(x0, y0, x1 - x0, y1 - y0);
+}  // _extend()
 
 
-// resize the array based 0/0
-void Sprite::_insertLeft(uint16_t count) {
-  ARGB blank;  // (0, 0, 0, GFXD_ALPHA_UNUSED);
+// Allocate the new data at once and copy the existing rows into it.
+template <class FORMAT>
+void SpriteT<FORMAT>::_resize(int16_t x, int16_t y, int16_t w, int16_t h) {
+  GFX_TRACE(" resize (%d/%d %d*%d) -> (%d/%d %d*%d)", _x, _y, _w, _h, x, y, w, h);
+  GFXDRAW_STAT(spriteResizes, 1);
 
-  // expand by multiple of 16
-  count = (count + 15) & 0xFFF0;
-  int16_t x2 = _x - count;
-  int16_t w2 = _w + count;
+  if ((x == _x) && (y == _y) && (w == _w)) {
+    // rows are added at the bottom only, the vector keeps the existing rows in place.
+    data.resize((size_t)w * h, FORMAT::transparent());
 
-  GFX_TRACE(" l-expand %d -> %d", _w, w2);
-  data.reserve(w2 * _h);  // alloc at once.
+  } else {
+    std::vector<Pixel> newData((size_t)w * h, FORMAT::transparent());
 
-  // insert blanks on each line
-  for (int16_t l = 0; l < _h; l++) {
-    data.insert(data.begin() + (l * w2), count, blank);
+    for (int16_t l = 0; l < _h; l++) {
+      auto src = data.begin() + (size_t)l * _w;
+      auto dst = newData.begin() + (size_t)(l + _y - y) * w + (_x - x);
+      std::copy(src, src + _w, dst);
+    }
+    data.swap(newData);
   }
-  _x = x2;
-  _w = w2;
-}  // _insertLeft
-
-
-// resize the array based 0/0
-void Sprite::_insertRight(uint16_t count) {
-  ARGB blank;  // (0, 0, 0, GFXD_ALPHA_UNUSED);
+  _x = x;
+  _y = y;
+  _w = w;
+  _h = h;
+}  // _resize()
 
-  // expand by multiple of 16
-  count = (count + 15) & 0xFFF0;
-  int16_t w2 = _w + count;
-  GFX_TRACE(" r-expand %d -> %d", _w, w2);
 
-  data.reserve(w2 * _h);  // alloc at once.
+// Copy the pixels of the runs back into the full rectangle.
+template <class FORMAT>
+void SpriteT<FORMAT>::_expand() {
+  GFX_TRACE(" expand (%d/%d %d*%d)", _x, _y, _w, _h);
+  std::vector<Pixel> newData((size_t)_w * _h, FORMAT::transparent());
 
-  // insert blanks on each line
-  for (int16_t l = 0; l < _h; l++) {
-    data.insert(data.begin() + (l * w2) + _w, count, blank);
+  auto src = data.begin();
+  for (int16_t y = 0; y < _h; y++) {
+    auto row = newData.begin() + (size_t)y * _w;
+    for (uint32_t r = _rowRuns[y]; r < _rowRuns[y + 1]; r++) {
+      std::copy(src, src + _runs[r].len, row + _runs[r].x);
+      src += _runs[r].len;
+    }
   }
 
-  _w = w2;
-}  // _insertRight
-
-
-// resize the array based 0/0
-void Sprite::_insertBottom(uint16_t count) {
-  ARGB blank;  // ARGB blank(0, 0, 0, GFXD_ALPHA_UNUSED);
-
-  // expand by multiple of 16
-  count = (count + 15) & 0xFFF0;
-  int16_t h2 = _h + count;
-  GFX_TRACE(" b-expand %d -> %d", _h, h2);
+  data.swap(newData);
+  _runs.clear();
+  _runs.shrink_to_fit();
+  _rowRuns.clear();
+  _rowRuns.shrink_to_fit();
+}  // _expand()
 
-  data.reserve(_w * h2);  // alloc at once.
 
-  data.insert(data.end(), count * _w, blank);
-  _h = h2;
-}  // _insertBottom
+// the Sprite classes of the supported pixel formats.
+template class SpriteT<PixelARGB>;
+template class SpriteT<PixelPARGB>;
+template class SpriteT<PixelRGB565>;
+template class SpriteT<PixelARGB4444>;
+template class SpriteT<PixelIndexed8>;
+template class SpriteT<PixelMask1>;
 
-}  // namespace
\ No newline at end of file
+}  // namespace
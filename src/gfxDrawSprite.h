@@ -15,8 +15,235 @@
 
 #include "gfxDraw.h"
 
+// Headroom in percent of the current size that is added to a side of a Sprite when it has to grow.
+#ifndef GFXDRAW_SPRITE_HEADROOM
+#define GFXDRAW_SPRITE_HEADROOM 25
+#endif
+
+// Changed pixels on a row with up to this number of unchanged pixels between them are combined into one dirty
+// rectangle because transferring a few unchanged pixels costs less than setting a new address window on the display.
+#ifndef GFXDRAW_DIRTY_GAP
+#define GFXDRAW_DIRTY_GAP 8
+#endif
+
+// The 16-bit value that marks transparent pixels in a RGB565 Sprite (magenta by default).
+#ifndef GFXDRAW_RGB565_TRANSPARENT
+#define GFXDRAW_RGB565_TRANSPARENT 0xF81F
+#endif
+
 namespace gfxDraw {
 
+// ===== Sprite pixel formats ====
+
+// A pixel format defines the type of the stored pixels, the value of transparent pixels and the conversions from and
+// to ARGB colors.  The conversions may use a state like a color palette.  sameColors() is true when the stored pixels
+// of two formats convert to the same colors so they can be compared without conversion.
+
+/// @brief Pixel format using ARGB with 32 bits per pixel, transparent pixels have Alpha 0.
+struct PixelARGB {
+  typedef ARGB Pixel;
+  static constexpr uint8_t bitsPerPixel = 32;
+  static Pixel transparent() {
+    return (ARGB());
+  };
+
+  static bool isVisible(Pixel p) {
+    return (p.Alpha > 0);
+  };
+
+  Pixel fromARGB(ARGB color) {
+    return (color);
+  };
+
+  ARGB toARGB(Pixel p) const {
+    return (p);
+  };
+
+  bool sameColors(const PixelARGB &) const {
+    return (true);
+  };
+
+  size_t memorySize() const {
+    return (0);
+  };
+};
+
+
+/// @brief Pixel format using colors with premultiplied alpha with 32 bits per pixel.
+/// The rows of these Sprites can be blended over a framebuffer by blendRow().
+struct PixelPARGB {
+  typedef PARGB Pixel;
+  static constexpr uint8_t bitsPerPixel = 32;
+
+  static Pixel transparent() {
+    return (PARGB());
+  };
+
+  static bool isVisible(Pixel p) {
+    return (p.raw != 0);
+  };
+
+  Pixel fromARGB(ARGB color) {
+    return (PARGB(color));
+  };
+
+  ARGB toARGB(Pixel p) const {
+    return (p.toARGB());
+  };
+
+  bool sameColors(const PixelPARGB &) const {
+    return (true);
+  };
+
+  size_t memorySize() const {
+    return (0);
+  };
+};
+
+
+/// @brief Pixel format using 16 bits per pixel with 5(R)+6(G)+5(B) bits as used by many displays.
+/// Transparent pixels use the GFXDRAW_RGB565_TRANSPARENT value, opaque pixels with this value are changed in the
+/// lowest green bit.
+struct PixelRGB565 {
+  typedef uint16_t Pixel;
+  static constexpr uint8_t bitsPerPixel = 16;
+  static Pixel transparent() {
+    return (GFXDRAW_RGB565_TRANSPARENT);
+  };
+
+  static bool isVisible(Pixel p) {
+    return (p != GFXDRAW_RGB565_TRANSPARENT);
+  };
+
+  Pixel fromARGB(ARGB color) {
+    if (color.Alpha == 0) return (GFXDRAW_RGB565_TRANSPARENT);
+    Pixel p = color.toColor16();
+    return ((p == GFXDRAW_RGB565_TRANSPARENT) ? (p ^ 0x0020) : p);
+  };
+
+  ARGB toARGB(Pixel p) const {
+    uint8_t r = (p >> 11) & 0x1F;
+    uint8_t g = (p >> 5) & 0x3F;
+    uint8_t b = p & 0x1F;
+    return (ARGB((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)));
+  };
+
+  bool sameColors(const PixelRGB565 &) const {
+    return (true);
+  };
+
+  size_t memorySize() const {
+    return (0);
+  };
+};
+
+
+/// @brief Pixel format using 16 bits per pixel with 4 bits for each of Alpha, Red, Green and Blue.
+/// Colors with a small Alpha value stay visible with the lowest Alpha value.
+struct PixelARGB4444 {
+  typedef uint16_t Pixel;
+  static constexpr uint8_t bitsPerPixel = 16;
+  static Pixel transparent() {
+    return (0);
+  };
+
+  static bool isVisible(Pixel p) {
+    return (p & 0xF000);
+  };
+
+  Pixel fromARGB(ARGB color) {
+    if (color.Alpha == 0) return (0);
+    uint8_t a = (color.Alpha < 0x10) ? 1 : (color.Alpha >> 4);
+    return ((a << 12) | ((color.Red >> 4) << 8) | ((color.Green >> 4) << 4) | (color.Blue >> 4));
+  };
+
+  ARGB toARGB(Pixel p) const {
+    return (ARGB(((p >> 8) & 0x0F) * 0x11, ((p >> 4) & 0x0F) * 0x11, (p & 0x0F) * 0x11, ((p >> 12) & 0x0F) * 0x11));
+  };
+
+  bool sameColors(const PixelARGB4444 &) const {
+    return (true);
+  };
+
+  size_t memorySize() const {
+    return (0);
+  };
+};
+
+
+/// @brief Pixel format using 8 bits per pixel as an index into a color palette (CLUT).
+/// Index 0 is used for transparent pixels.  New colors are added to the palette while drawing, when all 255 colors
+/// are used the nearest color is taken.  The palette can also be set before drawing.
+struct PixelIndexed8 {
+  typedef uint8_t Pixel;
+  static constexpr uint8_t bitsPerPixel = 8;
+  static Pixel transparent() {
+    return (0);
+  };
+
+  /// @brief The colors of the palette, the first entry is the transparent color.
+  std::vector<ARGB> palette = { ARGB_TRANSPARENT };
+
+  static bool isVisible(Pixel p) {
+    return (p != 0);
+  };
+
+  Pixel fromARGB(ARGB color);
+
+  /// @brief Find the index of a color in the palette without adding it.
+  /// @return false when the color is not in the palette.
+  bool findIndex(ARGB color, Pixel &p) const;
+
+  ARGB toARGB(Pixel p) const {
+    return (palette[p]);
+  };
+
+  /// @brief true when one palette starts with all colors of the other one so equal indices are equal colors.
+  bool sameColors(const PixelIndexed8 &other) const;
+
+  size_t memorySize() const {
+    return (palette.capacity() * sizeof(ARGB));
+  };
+
+private:
+  // the last found index, widgets draw many pixels with the same color.
+  Pixel _lastIndex = 0;
+};
+
+
+/// @brief Pixel format using 1 bit per pixel as a mask drawn with a single color.
+struct PixelMask1 {
+  typedef bool Pixel;
+  static constexpr uint8_t bitsPerPixel = 1;
+  static Pixel transparent() {
+    return (false);
+  };
+
+  /// @brief The color used for drawing the mask.
+  ARGB color = ARGB_BLACK;
+
+  static bool isVisible(Pixel p) {
+    return (p);
+  };
+
+  Pixel fromARGB(ARGB c) {
+    return (c.Alpha > 0);
+  };
+
+  ARGB toARGB(Pixel p) const {
+    return (p ? color : ARGB_TRANSPARENT);
+  };
+
+  bool sameColors(const PixelMask1 &other) const {
+    return (color.raw == other.color.raw);
+  };
+
+  size_t memorySize() const {
+    return (0);
+  };
+};
+
+
 // ===== Sprite ====
 
 /// The Sprite class allows off-screen pixels to be saved and used at a later time for various purpose.
@@ -26,32 +253,114 @@ namespace gfxDraw {
 /// * un-drawing something ba capturing the background pixels.
 ///
 /// This sprite class can be used without prior knowing the required size because it is extending automatically the internal buffer.
+/// The buffer grows with a headroom on the growing side so drawing a widget in any direction needs only a few
+/// reallocations.  When the size is known, e.g. from the bounding box of a path, reserve() allocates it at once.
+///
+/// A Sprite that is drawn often but not modified can be converted by compact() to store only the runs of
+/// non-transparent pixels per row.  Thin shapes like clock hands then use a fraction of the memory and drawing
+/// iterates the runs without testing the transparent pixels.
+///
+/// The pixels are stored in the given pixel format like PixelRGB565 to save memory.  The colors are converted when
+/// drawing into the Sprite and when drawing the Sprite by draw().  drawNative() passes the stored pixels without
+/// conversion to a display using the same format.  The Sprite class uses the ARGB format.
+///
+/// drawRows() and drawNativeRows() pass the sequences of non-transparent pixels on a row at once so displays can use
+/// a block transfer instead of a transaction per pixel.  The sequences are clipped by the clip rectangle.
+/// The rows of a SpritePARGB can be blended over the pixels of a framebuffer by blendRow().
+///
+/// When a Sprite is drawn for every frame, dirtyRects() and diff() compare it with the Sprite of the previous frame or
+/// a copy taken as a snapshot so only the changed pixels need to be sent to the display.
 
-class Sprite {
+template <class FORMAT>
+class SpriteT {
 public:
+  typedef typename FORMAT::Pixel Pixel;
+
+  /// @brief Callback function to draw a pixel in the format of the Sprite.
+  typedef std::function<void(int16_t x, int16_t y, Pixel p)> fDrawNative;
+
+  /// @brief Callback function to draw a horizontal sequence of pixels in the format of the Sprite.
+  typedef std::function<void(int16_t x, int16_t y, const Pixel *pixels, int16_t len)> fDrawNativeRow;
+
   // initialize a new Sprite without data.
-  Sprite();
+  SpriteT();
 
-  Sprite(int16_t x, int16_t y, int16_t w, int16_t h);
+  SpriteT(int16_t x, int16_t y, int16_t w, int16_t h);
 
   void drawPixel(int16_t x, int16_t y, ARGB color);
 
+  /// @brief Extend the allocated area to include the given rectangle to avoid reallocations while drawing.
+  /// @param x Left boundary.
+  /// @param y Top boundary.
+  /// @param w Width.
+  /// @param h Height.
+  void reserve(int16_t x, int16_t y, int16_t w, int16_t h);
+
   /// @brief change all pixels by applying a function to the color.
   /// @param cbMap the function to be applied to each pixel.
   /// @param mapAll if true all pixels are mapped, otherwise only non-transparent pixels.
   void mapColor(fMapColor cbMap, bool mapAll = false);
 
   /// @brief change all pixels with a specific color to another color.
+  /// The colors are compared in the format of the Sprite. With a palette only pixels with exactly the oldColor are
+  /// changed, nothing is changed when the oldColor is not in the palette.
   /// @param oldColor the color to be changed.
   /// @param newColor the new color.
   void mapColor(ARGB oldColor, ARGB newColor);
 
+  /// @brief Convert the pixels to runs of non-transparent pixels per row.
+  /// Drawing a pixel or mapping all pixels converts the Sprite back to the full rectangle.
+  void compact();
+
+  /// @brief Return true when the Sprite stores runs of pixels by compact().
+  bool isCompact() const {
+    return (!_rowRuns.empty());
+  };
+
+  /// @brief Return the number of bytes allocated for the pixels.
+  size_t memorySize() const;
+
+  /// @brief Access the pixel format, e.g. to set the palette or the mask color.
+  FORMAT &format() {
+    return (_format);
+  };
 
   /// @brief draw all current non-transparent pixels to the display.
   /// @param pos the position where the sprite should be drawn.
   /// @param cbDraw the callback function to draw a pixel on the display.
   void draw(Point pos, fDrawPixel cbDraw);
 
+  /// @brief draw all current non-transparent pixels without conversion to a display using the same pixel format.
+  /// @param pos the position where the sprite should be drawn.
+  /// @param cbDraw the callback function to draw a pixel on the display.
+  void drawNative(Point pos, fDrawNative cbDraw);
+
+  /// @brief draw the sequences of non-transparent pixels on the rows inside the clip rectangle.
+  /// @param pos the position where the sprite should be drawn.
+  /// @param cbRow the callback function to draw a sequence of pixels on the display.
+  void drawRows(Point pos, fDrawRow cbRow);
+
+  /// @brief draw the sequences of non-transparent pixels on the rows inside the clip rectangle without conversion.
+  /// @param pos the position where the sprite should be drawn.
+  /// @param cbRow the callback function to draw a sequence of pixels on the display.
+  void drawNativeRows(Point pos, fDrawNativeRow cbRow);
+
+  /// @brief Find the rectangles containing the pixels that differ from a previous frame.
+  /// Pixels differ when the visible colors differ, transparent pixels are equal.  Sprites with a different palette or
+  /// mask color are compared by the colors of the pixels.
+  /// The rectangles use the coordinates of the pixels in the Sprites.  Rows are combined into one rectangle while at
+  /// least half of its pixels are changed.  The new pixels in a rectangle can be drawn by drawRows() in a ClipScope.
+  /// @param previous the Sprite of the previous frame or a snapshot.
+  /// @return the list of rectangles, empty when both Sprites have the same pixels.
+  std::vector<BoundingBox> dirtyRects(const SpriteT &previous) const;
+
+  /// @brief Collect the pixels that differ from a previous frame into another Sprite.
+  /// @param previous the Sprite of the previous frame or a snapshot.
+  /// @param changes the Sprite receiving the changed pixels, the existing pixels are removed.
+  /// @param erase the color for the pixels that are transparent now but not in the previous frame,
+  /// e.g. the background color.  A SpriteMask1 draws these pixels with the mask color.
+  void diff(const SpriteT &previous, SpriteT &changes, ARGB erase) const;
+
 private:
   /// @brief Left boundary of the image
   int16_t _x;
@@ -62,28 +371,65 @@ private:
   /// @brief Height of the image
   int16_t _h;
 
-  /// @brief Allocated data
-  std::vector<ARGB> data;
+  /// @brief The pixel format with the conversion state.
+  FORMAT _format;
+
+  /// @brief Allocated data, in a compact Sprite the pixels of all runs.
+  std::vector<Pixel> data;
+
+  /// @brief A sequence of non-transparent pixels on a row of a compact Sprite.
+  struct _Run {
+    int16_t x;    ///< first pixel relative to the left boundary.
+    int16_t len;  ///< number of pixels.
+  };
+
+  /// @brief Index of the first run of every row and the end of the runs, empty when not compact.
+  std::vector<uint32_t> _rowRuns;
+
+  /// @brief The runs of all rows.
+  std::vector<_Run> _runs;
 
   // first initializing the data
   void _createData(int16_t x, int16_t y);
 
-  // resize the data array to include more pixels at the top
-  void _insertTop(uint16_t count);
+  // extend the data array with headroom to include the pixel
+  void _extend(int16_t x, int16_t y);
+
+  // re-allocate the data array for a new area and copy the existing pixels
+  void _resize(int16_t x, int16_t y, int16_t w, int16_t h);
+
+  // convert a compact Sprite back to the full rectangle
+  void _expand();
+
+  // set a pixel in the format of the Sprite
+  void _drawPixel(int16_t x, int16_t y, Pixel p);
+
+  // read the pixels of a row from x0 on, the data index n is used by compact Sprites reading the rows in order
+  void _readRow(int16_t y, int16_t x0, int32_t w, Pixel *buf, size_t &n) const;
 
-  // resize the data array to include more pixels at the left
-  void _insertLeft(uint16_t count);
+  // call the callback for every row of the area of both Sprites with the pixels and a function telling if a pixel changed
+  template <class TRow>
+  void _diffRows(const SpriteT &previous, TRow cbRow) const;
 
-  // resize the data array to include more pixels at the right
-  void _insertRight(uint16_t count);
+  // call the callback for all non-transparent pixels
+  template <class TDraw>
+  void _draw(Point pos, TDraw cbDraw);
 
-  // resize the data array to include more pixels at the bottom
-  void _insertBottom(uint16_t count);
+  // call the callback for all sequences of non-transparent pixels inside the clip rectangle with the data index
+  template <class TRun>
+  void _drawRuns(Point pos, TRun cbRun);
 
-};  // class Sprite
+};  // class SpriteT
 
 
+/// The Sprite class stores ARGB pixels.
+typedef SpriteT<PixelARGB> Sprite;
 
+typedef SpriteT<PixelPARGB> SpritePARGB;
+typedef SpriteT<PixelRGB565> SpriteRGB565;
+typedef SpriteT<PixelARGB4444> SpriteARGB4444;
+typedef SpriteT<PixelIndexed8> SpriteIndexed8;
+typedef SpriteT<PixelMask1> SpriteMask1;
 
 }  // namespace gfxDraw
 
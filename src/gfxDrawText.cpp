@@ -51,6 +51,7 @@ uint16_t _currentSize = 0;
 /// @brief Draw a single character at _textCursor and advance the _textCursor to the right
 /// @param c The character to be drawn.
 void drawChar(unsigned char c, fSetPixel cbDraw) {
+  GFXDRAW_STATS_SCOPE(statsScope);
   const GFXfont *_font;
 
   if (_currentFont) {
@@ -72,7 +73,14 @@ void drawChar(unsigned char c, fSetPixel cbDraw) {
       // Pointer to character specific bitmap.
       uint8_t *characterBytes = &bitmap[glyph->bitmapOffset];
 
-      for (uint8_t yy = 0; yy < glyph->height; yy++) {
+      // glyphs outside the clip rectangle are skipped, glyphs on the border are clipped by pixel.
+      const ClipRect &clip = _clipRect;
+      int16_t xe = xo + (_currentScale * glyph->width) - 1;
+      int16_t ye = yo + (_currentScale * glyph->height) - 1;
+      bool visible = clip.intersects(xo, yo, xe, ye);
+      bool covered = clip.covers(xo, yo, xe, ye);
+
+      for (uint8_t yy = 0; (visible) && (yy < glyph->height); yy++) {
         for (uint8_t xx = 0; xx < glyph->width; xx++) {
 
           if (!(bitCounter++ & 7)) {
@@ -82,13 +90,13 @@ void drawChar(unsigned char c, fSetPixel cbDraw) {
 
           // set pixels
           if (bits & 0x80) {
-            if (_currentScale == 1) {
-              cbDraw(xo + xx, yo + yy);
-
-            } else {
-              for (int16_t fy = 0; fy < _currentScale; fy++) {
-                for (int16_t fx = 0; fx < _currentScale; fx++) {
-                  cbDraw(xo + (_currentScale * xx) + fx, yo + (_currentScale * yy) + fy);
+            for (int16_t fy = 0; fy < _currentScale; fy++) {
+              for (int16_t fx = 0; fx < _currentScale; fx++) {
+                int16_t px = xo + (_currentScale * xx) + fx;
+                int16_t py = yo + (_currentScale * yy) + fy;
+                if ((covered) || (clip.contains(px, py))) {
+                  GFXDRAW_STAT(borderPixels, 1);
+                  cbDraw(px, py);
                 }
               }
             }
@@ -272,6 +280,7 @@ Point textBox(int16_t size, const char *text) {
 
 
 Point drawText(Point &p, int16_t size, const char *text, fSetPixel cbDraw) {
+  GFXDRAW_STATS_SCOPE(statsScope);
   _textCursor = p;
 
   if (size) {